@@ -0,0 +1,43 @@
+// File: Aether/Core/Asio.h
+#ifndef AETHER_CORE_ASIO_H
+#define AETHER_CORE_ASIO_H
+
+// Aether headers include Asio through this one, so every translation unit
+// sees the same configuration. Include an Aether header before any Asio
+// header of your own.
+
+#ifndef BOOST_ERROR_CODE_HEADER_ONLY
+#define BOOST_ERROR_CODE_HEADER_ONLY
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+// Opt-in io_uring backend: build everything with -DAETHER_IO_URING and link
+// with -luring. Socket accepts, reads and writes, timers and file reads then
+// go through io_uring instead of epoll. Needs Linux 5.10+ and Boost 1.78+.
+#if defined(AETHER_IO_URING)
+#include <boost/version.hpp>
+#if !defined(__linux__)
+#error "AETHER_IO_URING is only available on Linux"
+#endif
+#if BOOST_VERSION < 107800
+#error "AETHER_IO_URING needs Boost 1.78 or newer"
+#endif
+#if defined(__has_include)
+#if !__has_include(<liburing.h>)
+#error "AETHER_IO_URING needs liburing: install its headers (e.g. liburing-dev) and link with -luring"
+#endif
+#endif
+#ifndef BOOST_ASIO_HAS_IO_URING
+#define BOOST_ASIO_HAS_IO_URING
+#endif
+#ifndef BOOST_ASIO_DISABLE_EPOLL
+#define BOOST_ASIO_DISABLE_EPOLL // Sockets use io_uring too, not only files
+#endif
+#endif
+
+#include <utility> // Boost 1.74's awaitable.hpp uses std::exchange without including it
+#include <boost/asio.hpp>
+
+#endif // AETHER_CORE_ASIO_H
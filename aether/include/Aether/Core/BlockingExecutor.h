@@ -0,0 +1,78 @@
+#ifndef AETHER_BLOCKINGEXECUTOR_H
+#define AETHER_BLOCKINGEXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Aether {
+
+// Thread pool for work that blocks (disk reads, template rendering, CPU-heavy
+// handlers), kept apart from the EventLoop threads so it cannot hold up
+// accepts and reads. The queue is bounded: submit() refuses work once
+// maxQueue tasks are waiting instead of letting latency grow without limit.
+class BlockingExecutor {
+public:
+    struct Options {
+        std::size_t threads = 0;     // 0 picks hardware_concurrency
+        std::size_t maxQueue = 1024; // Waiting tasks, not counting running ones
+    };
+
+    // Counters since construction; the depth and running counts are current
+    struct Stats {
+        std::size_t queueDepth = 0;
+        std::size_t peakQueueDepth = 0;
+        std::size_t running = 0;
+        std::uint64_t submitted = 0;
+        std::uint64_t rejected = 0; // submit() returned false
+        std::uint64_t completed = 0;
+        std::chrono::microseconds totalWait{0}; // Time tasks spent queued
+        std::chrono::microseconds maxWait{0};
+        std::chrono::microseconds totalRun{0};
+    };
+
+    BlockingExecutor() : BlockingExecutor(Options()) {}
+    explicit BlockingExecutor(Options options);
+    ~BlockingExecutor(); // Runs the tasks already queued, then joins
+
+    BlockingExecutor(const BlockingExecutor&) = delete;
+    BlockingExecutor& operator=(const BlockingExecutor&) = delete;
+
+    // Queues task for a pool thread. Returns false, without running it, when
+    // the queue is full or the executor is stopping.
+    bool submit(std::function<void()> task);
+
+    Stats stats() const;
+    std::size_t threadCount() const { return threads_.size(); }
+
+    // True on a thread of any BlockingExecutor, i.e. inside a submitted task
+    static bool onPoolThread();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        std::function<void()> run;
+        Clock::time_point queuedAt;
+    };
+
+    void work();
+
+    const std::size_t maxQueue_;
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Task> queue_;
+    bool stopping_{false};
+    Stats stats_; // Guarded by mutex_
+    std::vector<std::thread> threads_;
+};
+
+} // namespace Aether
+
+#endif // AETHER_BLOCKINGEXECUTOR_H
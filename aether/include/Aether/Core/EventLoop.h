@@ -1,15 +1,7 @@
 #ifndef AETHER_EVENTLOOP_H
 #define AETHER_EVENTLOOP_H
 
-#ifndef BOOST_ERROR_CODE_HEADER_ONLY
-#define BOOST_ERROR_CODE_HEADER_ONLY
-#endif
-
-#ifndef BOOST_SYSTEM_NO_DEPRECATED
-#define BOOST_SYSTEM_NO_DEPRECATED
-#endif
-
-#include <boost/asio.hpp>
+#include "Aether/Core/Asio.h"
 #include <vector>
 #include <memory>
 #include <thread>
@@ -26,19 +18,24 @@ public:
 
     // Start N worker threads (N = hardware_concurrency, min 1)
     void start();
+
+    // Sharded (share-nothing) mode: start N worker threads that each run a
+    // private io_context (N = 0 picks hardware_concurrency). Anything bound to
+    // a shard's io_context stays on that thread for its whole life.
+    void startSharded(std::size_t numShards = 0);
     // Stop the loop and join all threads
     void stop();
 
     // High-performance templated post: avoids std::function allocation
     template <typename Handler>
     void post(Handler&& handler) {
-        boost::asio::post(*ioContext_, std::forward<Handler>(handler));
+        boost::asio::post(*ioContexts_.front(), std::forward<Handler>(handler));
     }
 
     // Optional: dispatch runs inline if already on this io_context's thread
     template <typename Handler>
     void dispatch(Handler&& handler) {
-        boost::asio::dispatch(*ioContext_, std::forward<Handler>(handler));
+        boost::asio::dispatch(*ioContexts_.front(), std::forward<Handler>(handler));
     }
 
     // Legacy overload if you still have call sites using std::function
@@ -47,15 +44,36 @@ public:
     // Block the calling thread while the event loop is running
     void keepAlive(); 
 
-    // Access to the underlying io_context
+    // Access to the underlying io_context (shard 0 in sharded mode)
     boost::asio::io_context& getIoContext();
 
+    // Access to a specific shard's io_context
+    boost::asio::io_context& getIoContext(std::size_t shard);
+
+    bool isSharded() const { return sharded_; }
+
+    // I/O backend compiled in: "io_uring" when built with AETHER_IO_URING
+    // (see Aether/Core/Asio.h), otherwise Asio's platform default such as
+    // "epoll" or "kqueue"
+    static const char* ioBackend();
+
+    // Number of io_contexts currently being run (1 unless sharded)
+    std::size_t shardCount() const { return activeShards_; }
+
 private:
-    std::unique_ptr<boost::asio::io_context> ioContext_;
-    std::unique_ptr<boost::asio::executor_work_guard<
-        boost::asio::io_context::executor_type>> workGuard_;
+    using WorkGuard = boost::asio::executor_work_guard<
+        boost::asio::io_context::executor_type>;
+
+    void launch(std::size_t numThreads, std::size_t numShards);
+
+    // ioContexts_[0] lives as long as the loop; extra shards are created on
+    // demand and kept so sockets bound to them never outlive their context.
+    std::vector<std::unique_ptr<boost::asio::io_context>> ioContexts_;
+    std::vector<std::unique_ptr<WorkGuard>> workGuards_;
     std::vector<std::thread> threads_;
     std::atomic<bool> running_{false};
+    bool sharded_{false};
+    std::size_t activeShards_{1};
 };
 
 } // namespace Aether
@@ -0,0 +1,130 @@
+// File: Aether/Http/Awaitable.h
+#ifndef AETHER_HTTP_AWAITABLE_H
+#define AETHER_HTTP_AWAITABLE_H
+
+#include "Aether/Core/BlockingExecutor.h"
+#include "Aether/Http/Connection.h"
+#include "Aether/Http/Middleware.h"
+#include "Aether/Http/Route.h"
+
+// Coroutine handlers need C++20 coroutines, which Asio detects
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace Aether {
+namespace Http {
+
+// Continues the middleware chain from a coroutine middleware. co_await next()
+// completes once the rest of the chain, coroutine handlers included, is done.
+class Next {
+public:
+    Next(Connection* connection, std::function<void(std::exception_ptr)> next)
+        : connection_(connection), next_(std::move(next)) {}
+
+    boost::asio::awaitable<void> operator()(std::exception_ptr error = nullptr) const {
+        const std::size_t holds = connection_ ? connection_->holds() : 0;
+        next_(error);
+        if (!connection_ || connection_->holds() <= holds) {
+            co_return; // Nothing further down is still running
+        }
+        boost::asio::steady_timer done(co_await boost::asio::this_coro::executor,
+                                       boost::asio::steady_timer::time_point::max());
+        bool released = false;
+        connection_->whenReleased(holds, [&done, &released]() {
+            released = true;
+            done.cancel();
+        });
+        if (released) {
+            co_return; // The connection closed meanwhile
+        }
+        boost::system::error_code ec;
+        co_await done.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+
+private:
+    Connection* connection_;
+    std::function<void(std::exception_ptr)> next_;
+};
+
+using AwaitableHandler = std::function<boost::asio::awaitable<void>(Request&, Response&)>;
+using AwaitableMiddleware = std::function<boost::asio::awaitable<void>(Request&, Response&, Context&, Next)>;
+
+// The connection whose strand coroutines for res run on. Null outside a
+// connection (e.g. in a test) and on a blocking route's pool thread, where
+// the chain owns the request until it returns.
+inline Connection* strandConnection(Response& res) {
+    return Aether::BlockingExecutor::onPoolThread() ? nullptr : Connection::of(res);
+}
+
+// Runs body on the connection's strand, holding the response until it
+// finishes, so the coroutine never runs alongside the connection's own
+// reads and writes. Without a strand connection it runs to completion on
+// the calling thread.
+template <typename Body>
+void spawnHeld(Response& res, Body body) {
+    Connection* connection = strandConnection(res);
+    if (!connection) {
+        boost::asio::io_context context;
+        std::exception_ptr error;
+        boost::asio::co_spawn(context, std::move(body), [&error](std::exception_ptr e) { error = e; });
+        context.run();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+
+    connection->hold();
+    boost::asio::co_spawn(connection->executor(), std::move(body),
+        [self = connection->shared_from_this()](std::exception_ptr error) {
+            self->release(error);
+        });
+}
+
+// Adapts a coroutine to a RequestHandler: the response is sent when the
+// coroutine finishes, and an exception it throws answers 500.
+//   server.get("/users/:id", coroutine([&db](Request& req, Response& res) -> boost::asio::awaitable<void> {
+//       res.sendJSON(co_await db.asyncFind(req.params["id"]));
+//   }));
+// Pass coroutines through coroutine(): a plain RequestHandler would drop the
+// awaitable without running it. On streamed routes subscribe to the body
+// with req.onData() from a synchronous handler instead; a coroutine starts
+// after the first body bytes have been delivered.
+inline RequestHandler coroutine(AwaitableHandler handler) {
+    auto shared = std::make_shared<const AwaitableHandler>(std::move(handler));
+    return [shared](Request& req, Response& res) {
+        spawnHeld(res, [shared, &req, &res]() { return (*shared)(req, res); });
+    };
+}
+
+// Adapts a coroutine middleware; co_await next() passes the request on.
+// Middleware that answers without calling next() ends the chain as usual.
+//   server.use(coroutine([](Request& req, Response& res, Context& ctx, Next next) -> boost::asio::awaitable<void> {
+//       if (co_await sessions.asyncCheck(req.header("cookie"))) co_await next();
+//       else res.send("Unauthorized", 401);
+//   }));
+inline Middleware coroutine(AwaitableMiddleware middleware) {
+    auto shared = std::make_shared<const AwaitableMiddleware>(std::move(middleware));
+    return [shared](Request& req, Response& res, Context& ctx, std::function<void(std::exception_ptr)> next) {
+        Next resume(strandConnection(res), std::move(next));
+        spawnHeld(res, [shared, &req, &res, &ctx, resume = std::move(resume)]() {
+            return (*shared)(req, res, ctx, resume);
+        });
+    };
+}
+
+} // namespace Http
+} // namespace Aether
+
+#endif // BOOST_ASIO_HAS_CO_AWAIT
+
+#endif // AETHER_HTTP_AWAITABLE_H
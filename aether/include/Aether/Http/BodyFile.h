@@ -0,0 +1,43 @@
+// File: Aether/Http/BodyFile.h
+#ifndef AETHER_HTTP_BODY_FILE_H
+#define AETHER_HTTP_BODY_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Aether {
+namespace Http {
+
+// A request body stored in an anonymous temporary file. The file is unlinked
+// from the start, so the kernel reclaims it as soon as the last BodyFile
+// referring to it is destroyed, however the connection ends.
+class BodyFile {
+public:
+    // Creates the file in directory; throws std::system_error on failure
+    explicit BodyFile(const std::string& directory);
+    ~BodyFile();
+
+    BodyFile(const BodyFile&) = delete;
+    BodyFile& operator=(const BodyFile&) = delete;
+
+    // Appends data at the end of the file; throws std::system_error
+    void append(std::string_view data);
+
+    // Maps the finished body read-only; data() is valid from then on
+    void seal();
+
+    std::string_view data() const { return std::string_view(mapping_, size_); }
+    std::size_t size() const { return size_; }
+    int fd() const { return fd_; }
+
+private:
+    int fd_ = -1;
+    std::size_t size_ = 0;
+    const char* mapping_ = nullptr;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_BODY_FILE_H
@@ -0,0 +1,63 @@
+// File: Aether/Http/ChunkedDecoder.h
+#ifndef AETHER_HTTP_CHUNKED_DECODER_H
+#define AETHER_HTTP_CHUNKED_DECODER_H
+
+#include <cstddef>
+#include <limits>
+#include <string_view>
+
+namespace Aether {
+namespace Http {
+
+// Resumable decoder for a Transfer-Encoding: chunked body. Feed it whatever
+// bytes have arrived; it walks the framing (chunk extensions and trailer
+// fields are accepted and skipped) and hands back chunk data as views into the
+// input, picking up where it left off on the next call.
+class ChunkedDecoder {
+public:
+    enum class Status {
+        Data,     // data holds the next piece of the body
+        NeedMore, // Input exhausted mid-body
+        Done,     // Last chunk and trailers consumed; later bytes are not the body's
+        Invalid,  // Malformed framing
+        TooLarge  // A chunk would take the body past the limit
+    };
+
+    static constexpr std::size_t kMaxLineBytes = 4 * 1024;     // Chunk size line, extensions included
+    static constexpr std::size_t kMaxTrailerBytes = 64 * 1024; // All trailer fields together
+
+    explicit ChunkedDecoder(std::size_t maxBodyBytes = std::numeric_limits<std::size_t>::max()) {
+        reset(maxBodyBytes);
+    }
+
+    // Starts a new body
+    void reset(std::size_t maxBodyBytes);
+
+    // Decodes from the start of input until there is a piece of data to hand
+    // back, the body ends, or input runs out. consumed is set to the bytes of
+    // input used either way; call again with the rest.
+    Status decode(std::string_view input, std::size_t& consumed, std::string_view& data);
+
+    std::size_t bodyBytes() const { return bodyBytes_; }
+
+private:
+    enum class State : unsigned char {
+        Size, SizeEnd, Extension, SizeLF,
+        Data, DataCR, DataLF,
+        TrailerStart, Trailer, TrailerLF, FinalLF,
+        Done, Failed
+    };
+
+    State state_ = State::Size;
+    std::size_t chunkRemaining_ = 0; // Size of the chunk being read, then what is left of it
+    std::size_t lineBytes_ = 0;      // Of the current size line
+    std::size_t trailerBytes_ = 0;
+    std::size_t bodyBytes_ = 0;
+    std::size_t maxBodyBytes_ = 0;
+    bool sawDigit_ = false;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_CHUNKED_DECODER_H
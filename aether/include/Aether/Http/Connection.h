@@ -5,23 +5,60 @@
 #include "Aether/Http/Request.h"
 #include "Aether/Http/Response.h"
 #include "Aether/Http/Middleware.h"
-#ifndef BOOST_ERROR_CODE_HEADER_ONLY
-#define BOOST_ERROR_CODE_HEADER_ONLY
-#endif
-#ifndef BOOST_SYSTEM_NO_DEPRECATED
-#define BOOST_SYSTEM_NO_DEPRECATED
-#endif
-#include <boost/asio.hpp>
+#include "Aether/Http/Route.h"
+#include "Aether/Http/ChunkedDecoder.h"
+#include "Aether/Http/TimerWheel.h"
+#include "Aether/Core/Asio.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace Aether {
 namespace Http {
 
-class Connection : public std::enable_shared_from_this<Connection> {
+// How long a connection may wait on the client before it is closed. Each
+// phase has its own deadline, tracked on the shard's timer wheel in sharded
+// mode and on the connection's own Asio timer otherwise.
+struct ConnectionTimeouts {
+    std::chrono::milliseconds idle{30000};   // For the first byte of the next request
+    std::chrono::milliseconds header{10000}; // For the rest of a request head, from its first byte
+    std::chrono::milliseconds body{30000};   // Between reads of a request body
+    std::chrono::milliseconds write{30000};  // For each write of responses to complete
+};
+
+// Per-server settings applied to every connection
+struct ConnectionOptions {
+    // Only fill Request::view (pointing into the read buffer) and leave the
+    // owned Request fields empty
+    bool zeroCopyRequests = false;
+
+    // Buffered bodies larger than this go to an unlinked file in
+    // spillDirectory instead of memory; 0 disables spilling
+    std::size_t spillThresholdBytes = 0;
+    std::string spillDirectory;
+
+    ConnectionTimeouts timeouts;
+};
+
+// Ownership of a published route table, kept by a connection across its
+// requests so that a lookup on an unchanged table takes no reference
+struct RoutePin {
+    std::uint64_t generation = 0; // Unique per published table; 0 is none
+    std::shared_ptr<const void> table;
+};
+
+class Connection : public std::enable_shared_from_this<Connection>, private ResponseStream {
 public:
-    using RequestHandler = std::function<void(Request&, Response&)>;
-    using HandlerLookup = std::function<RequestHandler(const std::string&, const std::string&, Request&)>;
+    using RequestHandler = Http::RequestHandler;
+    // Returns the matching route or nullptr. The route and the request's
+    // parameter names point into the server's route table, which pin keeps
+    // alive; the lookup only replaces pin when the table was republished.
+    using HandlerLookup = std::function<const Route*(Method, std::string_view, Request&, RoutePin&)>;
 
     static constexpr std::size_t kMaxBodySizeBytes = 10 * 1024 * 1024; // 10 MB safeguard
 
@@ -29,43 +66,152 @@ public:
         boost::asio::ip::tcp::socket socket,
         HandlerLookup handlerLookup,
         MiddlewareStack& middlewareStack,
-        std::function<void()> cleanupCallback
+        std::function<void()> cleanupCallback,
+        TimerService* timers, // The shard's wheel; null when several threads run the io_context
+        ConnectionOptions options = {}
     );
+    ~Connection();
 
     void start();
+    // Handlers that answer after returning (Response::defer(), and see
+    // Aether/Http/Awaitable.h). Each request holds its response while the
+    // handler side runs; the response is sent when the last hold() is
+    // released, and a release() with an error answers 500 instead. Only
+    // call these on the connection's executor, which serializes everything
+    // the connection does. The one exception is hold() from a blocking
+    // route, which runs while another hold is out and so never sends.
+    static Connection* of(Response& res); // Null when res is not attached to a connection
+    boost::asio::any_io_executor executor();
+    void hold();
+    void release(std::exception_ptr error = nullptr);
+    std::size_t holds() const { return holds_; }
+    // Runs callback once no more than holds remain, or the connection closes
+    void whenReleased(std::size_t holds, std::function<void()> callback);
+
     bool isKeepAliveRequested() const;
-    static bool iequals(const std::string& a, const std::string& b);
+    static bool iequals(std::string_view a, std::string_view b);
     static bool wantsKeepAlive(const Request& req);
-    static bool exceedsBodyLimit(std::size_t currentBytes, std::size_t incomingBytes);
+    static bool exceedsBodyLimit(std::size_t currentBytes, std::size_t incomingBytes,
+                                 std::size_t limit = kMaxBodySizeBytes);
+    // Checks a request's Transfer-Encoding list: 0 when it is just chunked,
+    // 400 when chunked is missing, repeated or not last, and 501 when chunked
+    // follows a coding the server does not decode (e.g. "gzip, chunked")
+    static int transferEncodingStatus(std::string_view value);
 
 private:
-    void handleReadHeaders(const boost::system::error_code& error, size_t bytes_transferred);
+    static constexpr std::size_t kMaxHeadBytes = 64 * 1024;  // Request line + headers
+    static constexpr std::size_t kReadChunkBytes = 16 * 1024;
+    static constexpr std::size_t kMaxBatchedResponses = 64; // Pipelined responses per write
+    static constexpr std::size_t kInlineBodyBytes = 1024; // Smaller bodies are copied next to their headers
+    static constexpr std::size_t kStreamBodyReadBytes = 64 * 1024; // Read size for streamed and chunked request bodies
+    static constexpr std::size_t kStreamHighWaterBytes = 64 * 1024; // Unsent streamed output before write() pushes back
+
+    // What the connection is waiting on, which picks the timeout
+    enum class Phase { Idle, Header, Body, Write };
+
+    // A response body written from its own buffer instead of being copied
+    // into responseData_
+    struct PendingBody {
+        std::size_t headerEnd; // Offset in responseData_ just past this response's headers
+        std::string body;
+        std::shared_ptr<const std::string> shared;
+    };
+
+    void readNextRequest();
+    void parseBufferedRequest();
+    void readMore();
+    void handleRequestHead(std::size_t headLength);
+    bool startStreamedRequest(bool hasBody);
+    bool deliverBody(std::string_view data);
     void handleContentLengthBody();
+    void readStreamedBody();
+    bool spillBody();
     void processRequest();
+    void runChain(); // Middleware, then the route; on a pool thread for blocking routes
+    void runChainBlocking(BlockingExecutor& pool);
+    void runRoute(const Route& route);
+    void callHandler(const Route& route);
+    void completeRequest();
+    void finishRequest();
     void buildResponse();
-    void sendResponse();
+    void appendResponseHead(std::size_t contentLength, bool streamed);
+    void flushResponses(std::function<void()> next);
     void handleNetworkError(const boost::system::error_code& error);
     void sendError(int statusCode);
-    void resetTimeout();
-    void handleChunkedBody();
+    void armTimeout(Phase phase);
+    void clearTimeout();
+    bool timeoutScheduled() const;
     void closeConnection(); // Declare closeConnection method
     void send100Continue(); // Declare send100Continue method
-    void processChunkedBody(size_t bytes_transferred); // Declare processChunkedBody method
+    ChunkedDecoder::Status decodeChunks(std::string_view input, std::size_t& consumed);
+    void readChunkedBody();
     void handleRequestBody(); // Declare handleRequestBody method
 
+    // ResponseStream: streamed (chunked) response bodies and deferred responses
+    bool write(std::string_view chunk) override;
+    void end() override;
+    void onDrain(std::function<void()> callback) override;
+    DeferredResponse defer() override;
+    void completeDeferred(DeferredResponse::Fill fill, std::exception_ptr error);
+    void pumpStream();
+    void handleStreamWritten();
+
     boost::asio::ip::tcp::socket socket_;
-    boost::asio::steady_timer timeoutTimer_;
+    TimerService* timers_;  // Shared by the connections of a shard; null without one
+    TimerWheel::Entry timeout_;
+    boost::asio::steady_timer timeoutTimer_; // Used when timers_ is null
+    bool timeoutArmed_{false};               // timeoutTimer_ holds a live deadline
+    Phase timeoutPhase_{Phase::Idle};
     HandlerLookup handlerLookup_;
     MiddlewareStack& middlewareStack_;
     std::function<void()> cleanupCallback_;
+    ConnectionOptions options_;
 
+    // Received bytes: the current request head (req_.view points into it)
+    // followed by any pipelined requests. Body bytes that had to be read
+    // separately go into req_.body instead.
     std::string requestBuffer_;
-    std::string responseData_;
+    std::size_t parseOffset_{0};   // Start of the next unparsed request
+    std::size_t scannedLength_{0}; // Bytes already searched for the end of the head
+    std::string decodedPath_;      // req_.view.path when it had to be percent-decoded
+    std::string chunkBuffer_; // Last read of a chunked body; after it, bytes of the next request
+    std::string responseData_; // Serialized responses not yet written (bodies may be separate)
+    std::vector<PendingBody> pendingBodies_;
+    std::vector<boost::asio::const_buffer> writeBuffers_;
+    std::size_t batchedResponses_{0};
     Request req_;
     Response res_;
 
     bool isClosed_; // Declare isClosed_ member variable
     std::size_t totalBodyBytes_{0};
+    std::size_t contentLength_{0};
+    ChunkedDecoder chunkDecoder_;
+    std::size_t bodyLimit_{kMaxBodySizeBytes};
+    const Route* route_{nullptr}; // Matched on the request head, or after middleware rewrote the path
+    RoutePin routePin_;           // Keeps route_'s table alive
+    bool handlerStarted_{false};  // The route's handler was called, i.e. no middleware answered first
+    bool offloaded_{false};       // A blocking route's chain is running on the pool
+    std::vector<std::function<void()>> afterOffload_; // Deferred completions waiting for that chain
+    bool streamingBody_{false};   // route_ takes the body through req.onData()
+    bool bodyUnread_{false};      // Answered without reading the body, so the connection must close
+    std::string bodyBuffer_;      // Piece of a streamed Content-Length body
+    bool keepAlive_{false}; // Decided by buildResponse()
+
+    // Streamed response state. streamPending_ collects output while a write
+    // is in flight from responseData_.
+    bool streamStarted_{false};
+    bool streamChunked_{false}; // false for HTTP/1.0: the body ends when the connection closes
+    bool streamEnded_{false};
+    bool writeInFlight_{false};
+    std::string streamPending_;
+    std::function<void()> drainCallback_;
+
+    // Outstanding hold()s on the current response, the handler side's own
+    // included. Atomic only because a blocking route may res.defer() from
+    // its pool thread; releases always run on the connection's executor.
+    std::atomic<std::size_t> holds_{0};
+    std::exception_ptr holdError_;
+    std::vector<std::pair<std::size_t, std::function<void()>>> holdWaiters_;
 };
 
 } // namespace Http
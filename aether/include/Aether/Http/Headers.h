@@ -0,0 +1,78 @@
+// File: Aether/Http/Headers.h
+#ifndef AETHER_HTTP_HEADERS_H
+#define AETHER_HTTP_HEADERS_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace Aether {
+namespace Http {
+
+// Headers the server or common middleware touch on the hot path. The parser
+// stores these in fixed slots on RequestView and Response keeps them in slots
+// too, so access is an array index instead of a hashed string lookup.
+enum class KnownHeader : unsigned char {
+    Accept,
+    AcceptEncoding,
+    AcceptLanguage,
+    Authorization,
+    CacheControl,
+    Connection,
+    ContentDisposition,
+    ContentEncoding,
+    ContentLength,
+    ContentType,
+    Cookie,
+    Date,
+    ETag,
+    Expect,
+    Host,
+    IfModifiedSince,
+    IfNoneMatch,
+    LastModified,
+    Location,
+    Origin,
+    Range,
+    Referer,
+    Server,
+    TransferEncoding,
+    Upgrade,
+    UserAgent,
+    Vary,
+    Count // Not a header: number of slots
+};
+
+constexpr std::size_t kKnownHeaderCount = static_cast<std::size_t>(KnownHeader::Count);
+
+constexpr std::size_t headerIndex(KnownHeader header) {
+    return static_cast<std::size_t>(header);
+}
+
+// Canonical wire name, e.g. "Content-Length"
+std::string_view knownHeaderName(KnownHeader header);
+
+// Lowercase name as used for Request::headers keys, e.g. "content-length"
+std::string_view knownHeaderKey(KnownHeader header);
+
+// Case-insensitive lookup; returns KnownHeader::Count for other names
+KnownHeader lookupKnownHeader(std::string_view name);
+
+// ASCII case-insensitive comparison
+inline bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        char x = a[i];
+        char y = b[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x | 0x20);
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y | 0x20);
+        if (x != y) return false;
+    }
+    return true;
+}
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_HEADERS_H
@@ -0,0 +1,23 @@
+// File: Aether/Http/HttpDate.h
+#ifndef AETHER_HTTP_HTTP_DATE_H
+#define AETHER_HTTP_HTTP_DATE_H
+
+#include <ctime>
+#include <string_view>
+
+namespace Aether {
+namespace Http {
+
+// Formats t as an IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT", RFC 7231
+// section 7.1.1.1) into out, which must hold at least 29 characters
+void formatHttpDate(std::time_t t, char* out);
+
+// Current time for the Date response header. Each thread keeps its own copy
+// and reformats it only when the (coarse) wall clock has moved to a new second,
+// so event loop workers never contend or format per response.
+std::string_view httpDate();
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_HTTP_DATE_H
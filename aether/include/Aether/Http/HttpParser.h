@@ -11,6 +11,12 @@ namespace Http {
 
 class HttpParser {
 public:
+    enum class ParseResult {
+        Complete,   // A full request head was parsed
+        Incomplete, // Need more bytes; call again once more data has arrived
+        Invalid     // Malformed request
+    };
+
     // Public methods for parsing
     // Convenience overload: keeps old signature
     static bool parseRequest(const std::string& rawRequest, Request& req);
@@ -18,12 +24,37 @@ public:
     // New, more efficient overload using string_view
     static bool parseRequest(std::string_view rawRequest, Request& req);
 
+    // Head parser for a buffer that grows as reads arrive. Parses the request
+    // line and headers at the start of buffer into req and sets headLength to
+    // the bytes they occupy, blank line included. After an Incomplete result,
+    // pass the buffer size of that call as searchedLength: the next call then
+    // only searches the new bytes for the blank line, and returns Incomplete
+    // without tokenizing anything until it is there. The head itself is
+    // always parsed from the start of buffer; no tokenizer state is kept.
+    static ParseResult parseRequestHead(std::string_view buffer, Request& req,
+                                        std::size_t& headLength, std::size_t searchedLength = 0);
+
+    // Zero-copy variant: fills only the view, whose fields point into buffer.
+    // view.path is split from the query but still percent-encoded; the owned
+    // variant above decodes req.path (see decodePath()).
+    static ParseResult parseRequestHead(std::string_view buffer, RequestView& view,
+                                        std::size_t& headLength, std::size_t searchedLength = 0);
+
+    // Scanner picked at startup: "avx2", "sse4.2" or "scalar"
+    static const char* scannerName();
+
     static std::string statusText(int statusCode);
 
+    // Full status line, e.g. "HTTP/1.1 404 Not Found\r\n", from a table built
+    // at compile time; codes outside 100-599 get "500 Internal Server Error"
+    static std::string_view statusLine(int statusCode);
+
 private:
-    // Internal parsing helpers (string_view-based)
-    static bool parseStartLine(std::string_view line, Request& req);
-    static bool parseHeaders(std::string_view headerBlock, Request& req);
+    // Internal parsing helpers; each returns the position just past what it
+    // consumed, or nullptr with result set to Incomplete/Invalid
+    static const char* parseStartLine(const char* p, const char* end, RequestView& view, ParseResult& result);
+    static const char* parseHeaders(const char* p, const char* end, RequestView& view, ParseResult& result);
+    static bool copyHead(const RequestView& view, Request& req); // false if the path is malformed
     static void parseBody(std::string_view bodyContent, Request& req);
 };
 
@@ -0,0 +1,66 @@
+// File: Aether/Http/Method.h
+#ifndef AETHER_HTTP_METHOD_H
+#define AETHER_HTTP_METHOD_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace Aether {
+namespace Http {
+
+// Request methods the server accepts. The parser maps the method token to one
+// of these once per request, and routing indexes per-method tables with it.
+enum class Method : unsigned char {
+    Get,
+    Head,
+    Post,
+    Put,
+    Delete,
+    Patch,
+    Options,
+    Count // Not a method: number of methods
+};
+
+constexpr std::size_t kMethodCount = static_cast<std::size_t>(Method::Count);
+
+constexpr std::size_t methodIndex(Method method) {
+    return static_cast<std::size_t>(method);
+}
+
+// Wire name, e.g. "PATCH"
+constexpr std::string_view methodName(Method method) {
+    constexpr std::array<std::string_view, kMethodCount> names = {{
+        "GET", "HEAD", "POST", "PUT", "DELETE", "PATCH", "OPTIONS"
+    }};
+    return method < Method::Count ? names[methodIndex(method)] : std::string_view();
+}
+
+// Case-sensitive, as method names are; returns Method::Count for other tokens
+constexpr Method lookupMethod(std::string_view token) {
+    switch (token.size()) {
+        case 3:
+            if (token == "GET") return Method::Get;
+            if (token == "PUT") return Method::Put;
+            break;
+        case 4:
+            if (token == "POST") return Method::Post;
+            if (token == "HEAD") return Method::Head;
+            break;
+        case 5:
+            if (token == "PATCH") return Method::Patch;
+            break;
+        case 6:
+            if (token == "DELETE") return Method::Delete;
+            break;
+        case 7:
+            if (token == "OPTIONS") return Method::Options;
+            break;
+    }
+    return Method::Count;
+}
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_METHOD_H
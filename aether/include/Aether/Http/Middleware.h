@@ -38,7 +38,11 @@ class MiddlewareStack {
 public:
     void use(Middleware middleware);
     void useError(ErrorMiddleware errorMiddleware);
-    void run(Request& req, Response& res, std::function<void()> next);
+    // Runs the chain and then next. A middleware may keep its next function
+    // and call it after run() has returned; the chain's Context stays alive
+    // until then.
+    void run(Request& req, Response& res, std::function<void()> next) const;
+    bool empty() const { return middlewares_.empty(); }
 
 private:
     std::vector<Middleware> middlewares_;
@@ -0,0 +1,118 @@
+// File: Aether/Http/Multipart.h
+#ifndef AETHER_HTTP_MULTIPART_H
+#define AETHER_HTTP_MULTIPART_H
+
+#include "Aether/Http/BodyFile.h"
+#include "Aether/Http/Request.h"
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Aether {
+namespace Http {
+
+struct MultipartPart {
+    std::string name;        // From Content-Disposition
+    std::string filename;    // Empty for plain form fields
+    std::string contentType; // Empty if the part did not declare one
+    std::vector<std::pair<std::string, std::string>> headers; // Names lowercased
+    std::size_t size = 0;    // Bytes of content received so far
+
+    // Content lives in data, or in file once the part outgrew
+    // MultipartOptions::spillThresholdBytes
+    std::string data;
+    std::shared_ptr<BodyFile> file;
+
+    std::string_view content() const {
+        return file ? file->data() : std::string_view(data);
+    }
+};
+
+// Incremental multipart body parser. Feed it the body in pieces of any size;
+// it reports each part's headers, content and end through the callbacks as
+// soon as they can be told apart from the boundary, without buffering the body.
+class MultipartParser {
+public:
+    using PartCallback = std::function<void(MultipartPart&)>;
+    using DataCallback = std::function<void(MultipartPart&, std::string_view)>;
+
+    // boundary as given in the Content-Type parameter (1 to 70 characters)
+    explicit MultipartParser(std::string_view boundary, std::size_t maxHeaderBytes = 16 * 1024);
+
+    // Boundary parameter of a multipart Content-Type value; empty if missing
+    static std::string boundaryFrom(std::string_view contentType);
+
+    void onPartBegin(PartCallback callback) { onPartBegin_ = std::move(callback); }
+    void onPartData(DataCallback callback) { onPartData_ = std::move(callback); }
+    void onPartEnd(PartCallback callback) { onPartEnd_ = std::move(callback); }
+
+    // Consumes the next piece of the body. Returns false once the body is
+    // malformed; error() then says why and further input is ignored.
+    bool feed(std::string_view data);
+
+    // True after the closing boundary
+    bool done() const { return state_ == State::Done; }
+    const std::string& error() const { return error_; }
+
+private:
+    enum class State { Preamble, DelimiterEnd, Headers, Body, Done, Error };
+
+    std::size_t search(std::string_view haystack) const;
+    std::size_t partialSuffix(std::string_view haystack) const;
+    void emit(std::string_view data);
+    void delimiterFound();
+    std::size_t feedDelimiterEnd(std::string_view data);
+    std::size_t feedHeaders(std::string_view data);
+    bool parsePartHeaders(std::string_view block);
+    bool fail(const char* reason);
+
+    std::string delimiter_;              // "\r\n--" + boundary
+    std::array<unsigned char, 256> skip_{}; // Horspool shift table for delimiter_
+    std::size_t maxHeaderBytes_;
+    State state_ = State::Preamble;
+    std::string carry_;                  // Tail that may begin a delimiter
+    std::string headerBuffer_;
+    char lastDelimiterChar_ = 0;         // First byte seen after a delimiter
+    MultipartPart part_;
+    std::string error_;
+
+    PartCallback onPartBegin_;
+    DataCallback onPartData_;
+    PartCallback onPartEnd_;
+};
+
+struct MultipartOptions {
+    std::size_t spillThresholdBytes = 0; // Parts above this go to a temp file; 0 keeps them in memory
+    std::string spillDirectory;          // Defaults to the system temp directory
+    std::size_t maxParts = 1000;
+    std::size_t maxHeaderBytes = 16 * 1024; // Per part
+};
+
+struct MultipartForm {
+    std::vector<MultipartPart> parts;
+    bool complete = false; // Closing boundary seen and nothing went wrong
+    std::string error;
+
+    const MultipartPart* find(std::string_view name) const;
+
+    // Content of the named part; empty view if absent
+    std::string_view field(std::string_view name) const;
+};
+
+// Collects the multipart/form-data body of a streaming route (see
+// RouteOptions::streaming()) as it arrives. Call from the handler; onComplete
+// runs in place of Request::onEnd with every part received, and the response
+// is sent once it returns. Returns false without touching req when the
+// request is not multipart or has no boundary.
+bool receiveMultipart(Request& req, MultipartOptions options,
+                      std::function<void(MultipartForm&)> onComplete);
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_MULTIPART_H
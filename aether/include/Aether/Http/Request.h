@@ -1,25 +1,264 @@
 #ifndef AETHER_HTTP_REQUEST_H
 #define AETHER_HTTP_REQUEST_H
 
+#include "Aether/Http/BodyFile.h"
+#include "Aether/Http/Headers.h"
+#include "Aether/Http/Method.h"
+#include "Aether/Http/RouteParams.h"
+#include "Aether/Http/Url.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Aether {
 namespace Http {
 
+// Non-owning view of a request as received. Everything points into the
+// connection's read buffer and stays valid until the response has been sent;
+// copy whatever must outlive that (see Request::materialize()).
+struct RequestView {
+    using Header = std::pair<std::string_view, std::string_view>;
+
+    std::string_view method;
+    Method methodId = Method::Count; // Parsed from method
+    std::string_view target;  // Raw request target
+    std::string_view path;    // Target up to '?', percent-decoded by the connection
+    std::string_view query;   // Raw text after '?', if any
+    std::string_view version;
+    std::array<std::string_view, kKnownHeaderCount> known{}; // Filled by the parser; null data() if absent
+    std::vector<Header> headers; // All other headers; names keep their original casing
+    std::string_view body;
+    RouteParams params;       // Filled by routing
+
+    std::string_view header(KnownHeader name) const {
+        return known[headerIndex(name)];
+    }
+
+    bool hasHeader(KnownHeader name) const {
+        return known[headerIndex(name)].data() != nullptr;
+    }
+
+    // Case-insensitive header lookup; empty view if absent
+    std::string_view header(std::string_view name) const {
+        const KnownHeader slot = lookupKnownHeader(name);
+        if (slot != KnownHeader::Count) {
+            return header(slot);
+        }
+        for (const auto& [key, value] : headers) {
+            if (equalsIgnoreCase(key, name)) {
+                return value;
+            }
+        }
+        return {};
+    }
+
+    bool hasHeader(std::string_view name) const {
+        const KnownHeader slot = lookupKnownHeader(name);
+        if (slot != KnownHeader::Count) {
+            return hasHeader(slot);
+        }
+        for (const auto& header : headers) {
+            if (equalsIgnoreCase(header.first, name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() {
+        method = target = path = query = version = body = {};
+        methodId = Method::Count;
+        known.fill({});
+        headers.clear(); // Keeps capacity for the next request on the connection
+        params.clear();
+    }
+};
+
 struct Request {
-    std::string method;  // GET/POST/PUT/DELETE
-    std::string path;    // Requested URL path
+    std::string method;  // GET/HEAD/POST/PUT/DELETE/PATCH/OPTIONS
+    std::string path;    // Requested URL path, percent-decoded, without the query
+    std::string queryString; // Raw query string (the part after '?')
     std::string version; // HTTP version (e.g., "HTTP/1.1")
     std::unordered_map<std::string, std::string> headers; // Request headers
     std::unordered_map<std::string, std::string> params; // URL parameters
     std::string body; // Request body
+
+    // Set instead of body when the body was spilled to disk (see
+    // Server::spillBodies()); view.body then points into its mapping.
+    // Holding on to it keeps the file alive past the response.
+    std::shared_ptr<BodyFile> bodyFile;
+
+    // Zero-copy view of the same request. Always filled by the connection;
+    // with Server::zeroCopyRequests(true) the owned fields above are left
+    // empty and handlers read from here instead. A copy of a Request does
+    // not keep it (it points into the connection's buffer): copying a
+    // zero-copy request materializes the copy.
+    RequestView view;
+
+    Request() = default;
+    Request(Request&&) = default;
+    Request& operator=(Request&&) = default;
+
+    Request(const Request& other) {
+        copyFrom(other);
+    }
+
+    Request& operator=(const Request& other) {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    // True when the connection only filled view (Server::zeroCopyRequests());
+    // the accessors below then read the view, and the owned fields otherwise,
+    // so that middleware edits to them are seen
+    bool zeroCopy() const {
+        return zeroCopy_;
+    }
+
+    void zeroCopy(bool enabled) {
+        zeroCopy_ = enabled;
+    }
+
+    // Copies the view into the owned fields (header names lowercased), for
+    // zero-copy handlers that need to keep request data past the response
+    void materialize() {
+        method.assign(view.method.data(), view.method.size());
+        path.assign(view.path.data(), view.path.size());
+        queryString.assign(view.query.data(), view.query.size());
+        version.assign(view.version.data(), view.version.size());
+        headers.clear();
+        for (std::size_t i = 0; i < kKnownHeaderCount; ++i) {
+            if (view.known[i].data()) {
+                headers.insert_or_assign(std::string(knownHeaderKey(static_cast<KnownHeader>(i))),
+                                         std::string(view.known[i]));
+            }
+        }
+        for (const auto& [key, value] : view.headers) {
+            headers.insert_or_assign(lowercase(key), std::string(value));
+        }
+        params.clear();
+        for (const auto& param : view.params) {
+            params.emplace(param.name, param.value);
+        }
+        if (body.data() != view.body.data()) {
+            body.assign(view.body.data(), view.body.size());
+        }
+    }
+
+    // O(1) access to a well-known header in both modes
+    std::string_view header(KnownHeader name) const {
+        if (zeroCopy_) {
+            return view.header(name);
+        }
+        auto it = headers.find(std::string(knownHeaderKey(name)));
+        return it != headers.end() ? std::string_view(it->second) : std::string_view();
+    }
+
+    bool hasHeader(KnownHeader name) const {
+        if (zeroCopy_) {
+            return view.hasHeader(name);
+        }
+        return headers.find(std::string(knownHeaderKey(name))) != headers.end();
+    }
+
+    // Case-insensitive header lookup that works in both modes
+    std::string_view header(std::string_view name) const {
+        if (zeroCopy_) {
+            return view.header(name);
+        }
+        auto it = findHeader(name);
+        return it != headers.end() ? std::string_view(it->second) : std::string_view();
+    }
+
+    bool hasHeader(std::string_view name) const {
+        if (zeroCopy_) {
+            return view.hasHeader(name);
+        }
+        return findHeader(name) != headers.end();
+    }
+
+    // Decoded value of a query parameter ("?limit=10" -> "10"); the first one
+    // if repeated, empty if absent. The query is parsed on the first call.
+    std::string_view query(std::string_view name) const {
+        for (const auto& [key, value] : queryParams()) {
+            if (key == name) {
+                return value;
+            }
+        }
+        return {};
+    }
+
+    // Query parameter parsed as a number, e.g. req.query<int>("limit");
+    // empty if absent or not entirely a number
+    template <typename T>
+    std::optional<T> query(std::string_view name) const {
+        for (const auto& [key, value] : queryParams()) {
+            if (key == name) {
+                return parseNumber<T>(value);
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool hasQuery(std::string_view name) const {
+        for (const auto& param : queryParams()) {
+            if (param.first == name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // All query parameters in order, decoded; valid until the request is cleared
+    const std::vector<QueryParams::Param>& queryParams() const {
+        return queryCache_.parse(zeroCopy_ ? view.query : std::string_view(queryString));
+    }
+
+    // Body callbacks for routes registered with RouteOptions::streamBody.
+    // Set them in the handler: onData receives each piece of the body as it
+    // arrives (the view is only valid during the call), then onEnd runs and
+    // the response is sent once it returns.
+    void onData(std::function<void(std::string_view)> callback) {
+        onData_ = std::move(callback);
+    }
+
+    void onEnd(std::function<void()> callback) {
+        onEnd_ = std::move(callback);
+    }
+
+    // Resets for the next request on a keep-alive connection, keeping capacity
+    void clear() {
+        method.clear();
+        path.clear();
+        queryString.clear();
+        version.clear();
+        headers.clear();
+        params.clear();
+        body.clear();
+        bodyFile.reset();
+        view.clear();
+        queryCache_.clear();
+        onData_ = nullptr;
+        onEnd_ = nullptr;
+    }
+
     // we need req.getURL();
     std::string getUrl() const {
-        return path + (params.empty() ? "" : "?" + paramsToString());
+        return path + (queryString.empty() ? "" : "?" + queryString);
     }
     // we need a way to ger the domain
     std::string getDomain() const {
+        if (zeroCopy_) {
+            return std::string(view.header(KnownHeader::Host));
+        }
         // should it ger from headers or be set separately?
         auto it = headers.find("host");
         if (it != headers.end()) {
@@ -33,19 +272,55 @@ struct Request {
         return ""; // Default case if Host header is not found
     }
 
-    
+
     private:
-        std::string paramsToString() const {
-            std::string result;
-            for (auto it = params.begin(); it != params.end(); ++it) {
-                if (it != params.begin()) {
-                    result += "&";
-                }
-                result += it->first + "=" + it->second;
+        friend class Connection;
+
+        static std::string lowercase(std::string_view name) {
+            std::string lower(name);
+            for (char& c : lower) {
+                if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+            }
+            return lower;
+        }
+
+        // The owned map is keyed by lowercase names
+        std::unordered_map<std::string, std::string>::const_iterator findHeader(std::string_view name) const {
+            const KnownHeader slot = lookupKnownHeader(name);
+            if (slot != KnownHeader::Count) {
+                return headers.find(std::string(knownHeaderKey(slot)));
             }
-            return result;
+            return headers.find(lowercase(name));
         }
 
+        void copyFrom(const Request& other) {
+            method = other.method;
+            path = other.path;
+            queryString = other.queryString;
+            version = other.version;
+            headers = other.headers;
+            params = other.params;
+            body = other.body;
+            bodyFile = other.bodyFile;
+            view.clear();
+            zeroCopy_ = false;
+            if (other.zeroCopy_) {
+                view = other.view;
+                materialize();
+                view.clear();
+            } else if (bodyFile) {
+                view.body = other.view.body; // The shared file keeps its mapping alive
+            }
+            queryCache_.clear();
+            onData_ = other.onData_;
+            onEnd_ = other.onEnd_;
+        }
+
+        std::function<void(std::string_view)> onData_;
+        std::function<void()> onEnd_;
+        mutable QueryParams queryCache_;
+        bool zeroCopy_ = false; // Kept across clear()
+
 };
 
 } // namespace Http
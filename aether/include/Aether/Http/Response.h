@@ -2,26 +2,152 @@
 #ifndef AETHER_HTTP_RESPONSE_H
 #define AETHER_HTTP_RESPONSE_H
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <regex>
 #include <filesystem>
 #include <algorithm>
+#include <stdexcept>
 #include "Aether/Core/json.hpp"
+#include "Aether/Http/Headers.h"
 
 namespace Aether {
 namespace Http {
 
+struct Response;
+
+// Handle for a response completed after its handler has returned (see
+// Response::defer()). Copies share one completion. complete() and fail() may
+// be called from any thread; only the first call counts. Dropping every copy
+// without completing answers 500.
+class DeferredResponse {
+public:
+    // Runs on the connection's thread, just before the response is sent
+    using Fill = std::function<void(Response&)>;
+    using Finish = std::function<void(Fill, std::exception_ptr)>;
+
+    DeferredResponse() = default;
+    explicit DeferredResponse(Finish finish) : state_(std::make_shared<State>(std::move(finish))) {}
+
+    void complete(Fill fill = nullptr) { finish(std::move(fill), nullptr); }
+    void fail(std::exception_ptr error) { finish(nullptr, std::move(error)); }
+    bool pending() const { return state_ && !state_->done.load(std::memory_order_acquire); }
+
+private:
+    struct State {
+        explicit State(Finish f) : finish(std::move(f)) {}
+        ~State() {
+            if (!done.exchange(true, std::memory_order_acq_rel)) {
+                finish(nullptr, std::make_exception_ptr(
+                    std::runtime_error("Deferred response dropped without completing")));
+            }
+        }
+
+        std::atomic<bool> done{false};
+        Finish finish;
+    };
+
+    void finish(Fill fill, std::exception_ptr error) {
+        if (state_ && !state_->done.exchange(true, std::memory_order_acq_rel)) {
+            state_->finish(std::move(fill), std::move(error));
+        }
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+// Output side of a streamed response, implemented by the connection that
+// owns the Response
+class ResponseStream {
+public:
+    virtual bool write(std::string_view chunk) = 0;
+    virtual void end() = 0;
+    virtual void onDrain(std::function<void()> callback) = 0;
+    virtual DeferredResponse defer() = 0;
+
+protected:
+    ~ResponseStream() = default;
+};
+
 struct Response {
     void send(const std::string& body, int statusCode = 200) {
         this->body = body;
         this->statusCode = statusCode;
+        sharedBody.reset();
+    }
+
+    // Sends a body that other responses may share (a cached page, a static
+    // asset) without copying it; the connection holds a reference until written
+    void sendShared(std::shared_ptr<const std::string> body, int statusCode = 200) {
+        sharedBody = std::move(body);
+        this->body.clear();
+        this->statusCode = statusCode;
+    }
+
+    std::string_view bodyView() const {
+        return sharedBody ? std::string_view(*sharedBody) : std::string_view(body);
+    }
+
+    // Streams the body instead of buffering it: the first write() sends the
+    // status and headers, then every chunk goes out as it is written
+    // (Transfer-Encoding: chunked). Returns false once the unsent output
+    // passes the connection's high-water mark; stop writing and resume from
+    // onDrain(). Only call from the handler or an onDrain() callback.
+    bool write(std::string_view chunk) {
+        if (!stream_) {
+            body.append(chunk.data(), chunk.size()); // Not attached to a connection
+            return true;
+        }
+        return stream_->write(chunk);
+    }
+
+    // Completes a streamed body; no effect before the first write()
+    void end() {
+        if (stream_) {
+            stream_->end();
+        }
+    }
+
+    // Runs callback once the unsent output has been written out
+    void onDrain(std::function<void()> callback) {
+        if (stream_) {
+            stream_->onDrain(std::move(callback));
+        } else {
+            callback();
+        }
+    }
+
+    // Holds the response back after the handler returns, until the handle
+    // completes. Hand the handle to another thread and set the response from
+    // complete()'s fill, which runs back on the connection's thread:
+    //   auto done = res.defer();
+    //   pool.submit([done]() mutable {
+    //       auto rows = slowQuery();
+    //       done.complete([rows](Response& res) { res.sendJSON(rows); });
+    //   });
+    DeferredResponse defer() {
+        if (!stream_) {
+            // Not attached to a connection: fill runs on the completing thread
+            return DeferredResponse([this](DeferredResponse::Fill fill, std::exception_ptr) {
+                if (fill) {
+                    fill(*this);
+                }
+            });
+        }
+        return stream_->defer();
     }
 
     void sendJSON(const std::string& json, int statusCode = -1) {
-        setHeader("Content-Type", "application/json");
+        setHeader(KnownHeader::ContentType, "application/json");
         
         // If no status code provided, use the current one
         if (statusCode == -1) {
@@ -31,14 +157,65 @@ struct Response {
         send(json, statusCode);
     }
 
+    // Well-known names go to their slot (see below), so read them back with
+    // getHeader() rather than from headers. A well-known name written
+    // straight into headers is still sent once: it moves to its slot when
+    // the response is written, unless setHeader() already filled the slot.
     void setHeader(const std::string& key, const std::string& value) {
+        const KnownHeader slot = lookupKnownHeader(key);
+        if (slot != KnownHeader::Count) {
+            setHeader(slot, value);
+            return;
+        }
         headers[key] = value;
     }
 
+    // Well-known headers live in fixed slots and are written with their
+    // canonical names
+    void setHeader(KnownHeader name, std::string_view value) {
+        knownHeaders[headerIndex(name)].assign(value.data(), value.size());
+        knownHeaderMask |= maskBit(name);
+    }
+
+    bool hasHeader(KnownHeader name) const {
+        return (knownHeaderMask & maskBit(name)) != 0;
+    }
+
+    // Empty if the header was not set
+    std::string_view getHeader(KnownHeader name) const {
+        return hasHeader(name) ? std::string_view(knownHeaders[headerIndex(name)]) : std::string_view();
+    }
+
+    // Case-insensitive, in the slots or in headers; empty if not set
+    std::string_view getHeader(std::string_view name) const {
+        const KnownHeader slot = lookupKnownHeader(name);
+        if (slot != KnownHeader::Count && hasHeader(slot)) {
+            return getHeader(slot);
+        }
+        for (const auto& [key, value] : headers) {
+            if (equalsIgnoreCase(key, name)) {
+                return value;
+            }
+        }
+        return {};
+    }
+
+    void removeHeader(KnownHeader name) {
+        knownHeaderMask &= ~maskBit(name);
+        knownHeaders[headerIndex(name)].clear();
+    }
+
     void setStatus(int statusCode) {
         this->statusCode = statusCode;
     }
 
+    // The 404 the server sends for a path no route matches, for handlers
+    // that find the path names nothing after all
+    void sendNotFound() {
+        setHeader(KnownHeader::ContentType, "text/html");
+        send("<html><body><h1>404 Not Found</h1></body></html>", 404);
+    }
+
     void render(const std::string& viewName, const nlohmann::json& data = {}) {
         std::error_code ec;
         auto base = std::filesystem::weakly_canonical(viewsFolder_, ec);
@@ -186,13 +363,42 @@ struct Response {
     }
 
     std::string body;
+    std::shared_ptr<const std::string> sharedBody; // Sent instead of body when set
     int statusCode = 200; // Default to 200 OK
-    std::unordered_map<std::string, std::string> headers;
+    std::unordered_map<std::string, std::string> headers; // Headers without a KnownHeader slot
+    std::array<std::string, kKnownHeaderCount> knownHeaders; // Indexed by KnownHeader
+    std::uint32_t knownHeaderMask = 0; // Bit i set when knownHeaders[i] was set
 
     // Declare the static member variable
     static std::string viewsFolder_;
 
 private:
+    friend class Connection;
+    ResponseStream* stream_ = nullptr;
+
+    static_assert(kKnownHeaderCount <= 32, "knownHeaderMask needs a bit per KnownHeader");
+
+    static constexpr std::uint32_t maskBit(KnownHeader name) {
+        return std::uint32_t{1} << headerIndex(name);
+    }
+
+    // Moves well-known names found in headers into their slots, which are
+    // what the connection writes; a slot that is already set wins
+    void mergeKnownHeaders() {
+        for (auto it = headers.begin(); it != headers.end();) {
+            const KnownHeader slot = lookupKnownHeader(it->first);
+            if (slot == KnownHeader::Count) {
+                ++it;
+                continue;
+            }
+            if (!hasHeader(slot)) {
+                knownHeaders[headerIndex(slot)] = std::move(it->second);
+                knownHeaderMask |= maskBit(slot);
+            }
+            it = headers.erase(it);
+        }
+    }
+
     static std::string htmlEscape(const std::string& value) {
         std::string escaped;
         escaped.reserve(value.size());
@@ -0,0 +1,76 @@
+// File: Aether/Http/Route.h
+#ifndef AETHER_HTTP_ROUTE_H
+#define AETHER_HTTP_ROUTE_H
+
+#include "Aether/Http/Middleware.h"
+#include "Aether/Http/Request.h"
+#include "Aether/Http/Response.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Aether {
+
+class BlockingExecutor;
+
+namespace Http {
+
+using RequestHandler = std::function<void(Request&, Response&)>;
+
+// Per-route settings, e.g.
+//   server.post("/upload", handler, RouteOptions().streaming().bodyLimit(8ull << 30));
+struct RouteOptions {
+    // Largest accepted request body; 0 means the default, which is
+    // Connection::kMaxBodySizeBytes for buffered bodies and no limit for
+    // streamed ones. Larger Content-Lengths are refused with 413 before any
+    // 100 Continue is sent.
+    std::size_t maxBodyBytes = 0;
+
+    // Run the handler as soon as the request head has arrived and hand it the
+    // body through req.onData()/req.onEnd() instead of buffering it in req.body
+    bool streamBody = false;
+
+    // Run the request on the server's BlockingExecutor instead of the I/O
+    // thread, for handlers that read files, render templates or otherwise
+    // block. Middleware runs there too, before and after the handler. When
+    // the executor's queue is full the request is answered 503.
+    bool runBlocking = false;
+
+    // Runs in order before the handler, after the server-wide middleware,
+    // and only for this route. On streamed routes both run on the request
+    // head, before any of the body is accepted.
+    std::vector<Middleware> middleware;
+
+    RouteOptions& bodyLimit(std::size_t bytes) {
+        maxBodyBytes = bytes;
+        return *this;
+    }
+
+    RouteOptions& streaming(bool enabled = true) {
+        streamBody = enabled;
+        return *this;
+    }
+
+    RouteOptions& blocking(bool enabled = true) {
+        runBlocking = enabled;
+        return *this;
+    }
+
+    RouteOptions& use(Middleware m) {
+        middleware.push_back(std::move(m));
+        return *this;
+    }
+};
+
+struct Route {
+    RequestHandler handler;
+    RouteOptions options;
+    std::shared_ptr<const MiddlewareStack> middleware; // From options.middleware; null if none
+    BlockingExecutor* blocking = nullptr; // Set by the server for options.runBlocking
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_ROUTE_H
@@ -0,0 +1,68 @@
+// File: Aether/Http/RouteConstraint.h
+#ifndef AETHER_HTTP_ROUTE_CONSTRAINT_H
+#define AETHER_HTTP_ROUTE_CONSTRAINT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Aether {
+namespace Http {
+
+// What a ":name(...)" route parameter accepts. The built-in constraints are
+// hand-written scanners:
+//   int    optional sign, then digits that fit in std::int64_t
+//   uint   digits that fit in std::uint64_t
+//   uuid   8-4-4-4-12 hex digits
+//   hex    one or more hex digits
+//   slug   one or more letters, digits, '-' or '_'
+//   alpha  one or more ASCII letters
+// Anything else is a regular expression that must match the whole segment.
+// It is compiled once into a DFA, so matching is one table lookup per byte.
+// Supported syntax: literals, '.', [classes] with ranges and negation,
+// \d \w \s \D \W \S, groups, '|', and the quantifiers * + ? {n} {n,} {n,m}.
+// Backreferences, lookaround and lazy quantifiers are rejected.
+class RouteConstraint {
+public:
+    enum class Kind : unsigned char { Int, Uint, Uuid, Hex, Slug, Alpha, Regex };
+
+    // Builds the constraint written between the parentheses; throws
+    // std::invalid_argument for a regex this matcher cannot compile
+    static std::shared_ptr<const RouteConstraint> parse(std::string_view text);
+
+    bool matches(std::string_view segment) const;
+
+    Kind kind() const { return kind_; }
+
+    // As written in the pattern; equal text means an equal constraint
+    const std::string& text() const { return text_; }
+
+    // Number of DFA states, for regex constraints
+    std::size_t stateCount() const { return accepting_.size(); }
+
+private:
+    RouteConstraint(Kind kind, std::string_view text) : kind_(kind), text_(text) {}
+
+    void compileRegex();
+    bool matchRegex(std::string_view segment) const;
+
+    Kind kind_;
+    std::string text_;
+
+    // Regex DFA. Bytes are first mapped to classes of bytes the expression
+    // cannot tell apart, which keeps the table small. State 0 is dead.
+    std::array<unsigned char, 256> byteClass_{};
+    std::size_t classCount_ = 0;
+    std::uint16_t start_ = 0;
+    std::vector<std::uint16_t> transitions_; // state * classCount_ + class
+    std::vector<bool> accepting_;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_ROUTE_CONSTRAINT_H
@@ -0,0 +1,61 @@
+// File: Aether/Http/RouteGroup.h
+#ifndef AETHER_HTTP_ROUTEGROUP_H
+#define AETHER_HTTP_ROUTEGROUP_H
+
+#include "Aether/Http/Method.h"
+#include "Aether/Http/Middleware.h"
+#include "Aether/Http/Route.h"
+#include <string>
+#include <vector>
+
+namespace Aether {
+namespace Http {
+
+class Server;
+
+// Routes sharing a path prefix and middleware, registered on a Server:
+//   auto api = server.group("/api/v1").use(requireAuth);
+//   api.get("/users/:id", handler);   // GET /api/v1/users/:id, behind requireAuth
+// Routes land in the server's route tree under the prefix, so the prefix is
+// one shared node that lookup walks once however many routes sit below it.
+// The group's middleware runs only for its routes, after the server-wide
+// stack and before any middleware of the route itself. It is captured when a
+// route is registered, so call use() before adding the routes it covers.
+// Groups from Server::vhost() register on that host's routes instead.
+class RouteGroup {
+public:
+    // host: the virtual host the routes belong to (see Server::vhost());
+    // empty for the Server's own routes
+    RouteGroup(Server& server, const std::string& prefix, std::string host = {});
+
+    // Adds middleware for routes registered on this group from now on
+    RouteGroup& use(Middleware middleware);
+
+    // Nested group under this prefix; starts with this group's middleware
+    RouteGroup group(const std::string& prefix) const;
+
+    RouteGroup& get(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    RouteGroup& post(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    RouteGroup& put(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    RouteGroup& del(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    RouteGroup& patch(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    RouteGroup& head(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    RouteGroup& options(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    RouteGroup& route(Method method, const std::string& path, RequestHandler handler,
+                      RouteOptions options = {});
+
+    // Normalized: starts with '/' unless empty, never ends with one
+    const std::string& prefix() const { return prefix_; }
+    const std::string& host() const { return host_; }
+
+private:
+    Server& server_;
+    std::string prefix_;
+    std::string host_;
+    std::vector<Middleware> middleware_;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_ROUTEGROUP_H
@@ -0,0 +1,46 @@
+// File: Aether/Http/RouteParams.h
+#ifndef AETHER_HTTP_ROUTEPARAMS_H
+#define AETHER_HTTP_ROUTEPARAMS_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace Aether {
+namespace Http {
+
+class RouteTree;
+
+// Parameters captured by a route lookup. Names point into the route tree and
+// values into the looked-up path, so both are only valid while those live.
+// Fixed capacity keeps lookups allocation-free.
+class RouteParams {
+public:
+    static constexpr std::size_t kMaxParams = 16;
+
+    struct Param {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    void clear() { size_ = 0; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const Param* begin() const { return params_.data(); }
+    const Param* end() const { return params_.data() + size_; }
+
+    // Returns the captured value for name, or an empty view if absent
+    std::string_view get(std::string_view name) const;
+
+private:
+    friend class RouteTree;
+
+    std::array<Param, kMaxParams> params_{};
+    std::size_t size_ = 0;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_ROUTEPARAMS_H
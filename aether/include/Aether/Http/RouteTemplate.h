@@ -0,0 +1,221 @@
+// File: Aether/Http/RouteTemplate.h
+#ifndef AETHER_HTTP_ROUTE_TEMPLATE_H
+#define AETHER_HTTP_ROUTE_TEMPLATE_H
+
+#include "Aether/Http/Route.h"
+#include "Aether/Http/RouteParams.h"
+#include "Aether/Http/Url.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Aether {
+namespace Http {
+
+// Value type a route template parameter declares: ":id(int)" is passed to
+// the handler as std::int64_t, ":n(uint)" as std::uint64_t, and everything
+// else (":slug", ":key(uuid)", "*rest") as std::string_view
+enum class ParamType : unsigned char { String, Int, Uint };
+
+// A route pattern checked at compile time
+struct RouteTemplateInfo {
+    enum Error : unsigned char {
+        None,
+        NoLeadingSlash,
+        BadParamName,
+        UnknownType,
+        UnclosedType,
+        WildcardNotLast,
+        DuplicateParam,
+        TooManyParams,
+        ReservedChar
+    };
+
+    Error error = None;
+    std::size_t paramCount = 0;
+    std::array<ParamType, RouteParams::kMaxParams> types{};
+    std::array<std::string_view, RouteParams::kMaxParams> names{};
+};
+
+constexpr bool isParamNameChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Same syntax as the runtime RoutePattern, restricted to the built-in
+// constraints (regex constraints are runtime only); every mistake
+// RoutePattern would accept or throw on is an error here
+constexpr RouteTemplateInfo parseRouteTemplate(std::string_view pattern) {
+    RouteTemplateInfo info;
+    if (pattern.empty() || pattern[0] != '/') {
+        info.error = RouteTemplateInfo::NoLeadingSlash;
+        return info;
+    }
+
+    bool sawWildcard = false;
+    std::size_t pos = 0;
+    while (pos < pattern.size()) {
+        if (pattern[pos] == '/') {
+            ++pos;
+            continue;
+        }
+        const std::size_t slash = pattern.find('/', pos);
+        const std::size_t end = slash == std::string_view::npos ? pattern.size() : slash;
+        const std::string_view segment = pattern.substr(pos, end - pos);
+        pos = end;
+
+        if (sawWildcard) {
+            info.error = RouteTemplateInfo::WildcardNotLast;
+            return info;
+        }
+
+        if (segment[0] == ':' || segment[0] == '*') {
+            std::string_view name = segment.substr(1);
+            ParamType type = ParamType::String;
+            if (segment[0] == ':') {
+                const std::size_t open = name.find('(');
+                if (open != std::string_view::npos) {
+                    if (name.back() != ')') {
+                        info.error = RouteTemplateInfo::UnclosedType;
+                        return info;
+                    }
+                    const std::string_view typeName = name.substr(open + 1, name.size() - open - 2);
+                    if (typeName == "int") {
+                        type = ParamType::Int;
+                    } else if (typeName == "uint") {
+                        type = ParamType::Uint;
+                    } else if (typeName != "uuid" && typeName != "hex" && typeName != "slug" &&
+                               typeName != "alpha") {
+                        info.error = RouteTemplateInfo::UnknownType;
+                        return info;
+                    }
+                    name = name.substr(0, open);
+                }
+                if (name.empty()) {
+                    info.error = RouteTemplateInfo::BadParamName;
+                    return info;
+                }
+            } else {
+                sawWildcard = true;
+                if (name.empty()) {
+                    name = "*"; // Bare "*" is named "*", as in RoutePattern
+                }
+            }
+            for (std::size_t i = 0; i < name.size() && name != "*"; ++i) {
+                if (!isParamNameChar(name[i])) {
+                    info.error = RouteTemplateInfo::BadParamName;
+                    return info;
+                }
+            }
+            if (info.paramCount == RouteParams::kMaxParams) {
+                info.error = RouteTemplateInfo::TooManyParams;
+                return info;
+            }
+            for (std::size_t i = 0; i < info.paramCount; ++i) {
+                if (info.names[i] == name) {
+                    info.error = RouteTemplateInfo::DuplicateParam;
+                    return info;
+                }
+            }
+            info.names[info.paramCount] = name;
+            info.types[info.paramCount] = type;
+            ++info.paramCount;
+        } else {
+            for (char c : segment) {
+                if (c == ':' || c == '*' || c == '(' || c == ')' || c == '?' || c == '#' || c == '%') {
+                    info.error = RouteTemplateInfo::ReservedChar;
+                    return info;
+                }
+            }
+        }
+    }
+    return info;
+}
+
+template <ParamType Type>
+struct ParamValue {
+    using type = std::string_view;
+};
+
+template <>
+struct ParamValue<ParamType::Int> {
+    using type = std::int64_t;
+};
+
+template <>
+struct ParamValue<ParamType::Uint> {
+    using type = std::uint64_t;
+};
+
+// Binds a handler taking typed parameters to a route template. Pattern must
+// be a constexpr char array with static storage, since C++17 cannot take a
+// string literal as a template argument:
+//   static constexpr char kPost[] = "/users/:id(int)/posts/:slug";
+//   server.get<kPost>([](Request&, Response&, std::int64_t id, std::string_view slug) { ... });
+template <const char* Pattern>
+class RouteTemplate {
+public:
+    static constexpr RouteTemplateInfo info = parseRouteTemplate(Pattern);
+
+    static_assert(info.error != RouteTemplateInfo::NoLeadingSlash, "Route template must start with '/'");
+    static_assert(info.error != RouteTemplateInfo::BadParamName,
+                  "Route parameter names must be non-empty and use only letters, digits and '_'");
+    static_assert(info.error != RouteTemplateInfo::UnknownType,
+                  "Route parameter constraint must be int, uint, uuid, hex, slug or alpha");
+    static_assert(info.error != RouteTemplateInfo::UnclosedType, "Route parameter type is missing its ')'");
+    static_assert(info.error != RouteTemplateInfo::WildcardNotLast, "A '*' wildcard must be the last segment");
+    static_assert(info.error != RouteTemplateInfo::DuplicateParam, "Route parameter names must be unique");
+    static_assert(info.error != RouteTemplateInfo::TooManyParams, "Too many parameters in route template");
+    static_assert(info.error != RouteTemplateInfo::ReservedChar,
+                  "Static route segments cannot contain ':', '*', '(', ')', '?', '#' or '%'");
+
+    template <typename Handler>
+    static RequestHandler bind(Handler handler) {
+        checkHandler<Handler>(std::make_index_sequence<info.paramCount>());
+        return [handler = std::move(handler)](Request& req, Response& res) mutable {
+            invoke(handler, req, res, std::make_index_sequence<info.paramCount>());
+        };
+    }
+
+private:
+    template <typename Handler, std::size_t... I>
+    static constexpr void checkHandler(std::index_sequence<I...>) {
+        static_assert(std::is_invocable_v<Handler&, Request&, Response&,
+                                          typename ParamValue<info.types[I]>::type...>,
+                      "Handler must take (Request&, Response&) followed by one argument per route "
+                      "parameter, in order: std::int64_t for (int), std::uint64_t for (uint), "
+                      "std::string_view otherwise");
+    }
+
+    template <ParamType Type>
+    static std::optional<typename ParamValue<Type>::type> convert(std::string_view value) {
+        if constexpr (Type == ParamType::String) {
+            return value;
+        } else {
+            return parseNumber<typename ParamValue<Type>::type>(value);
+        }
+    }
+
+    template <typename Handler, std::size_t... I>
+    static void invoke(Handler& handler, Request& req, Response& res, std::index_sequence<I...>) {
+        // The route tree captures parameters in path order, so the I-th
+        // capture is the I-th template parameter; no lookup by name
+        const RouteParams::Param* params = req.view.params.begin();
+        (void)params;
+        const auto values = std::make_tuple(convert<info.types[I]>(params[I].value)...);
+        if (!(std::get<I>(values).has_value() && ...)) {
+            res.sendNotFound(); // The path names nothing of this type, as if no route matched
+            return;
+        }
+        handler(req, res, *std::get<I>(values)...);
+    }
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_ROUTE_TEMPLATE_H
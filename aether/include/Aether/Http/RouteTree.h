@@ -0,0 +1,66 @@
+// File: Aether/Http/RouteTree.h
+#ifndef AETHER_HTTP_ROUTETREE_H
+#define AETHER_HTTP_ROUTETREE_H
+
+#include "Aether/Http/RoutePattern.h"
+#include "Aether/Http/RouteParams.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Aether {
+namespace Http {
+
+// Compressed prefix tree over path segments. Chains of static segments share
+// a single node, ":param" segments match any one segment and "*wildcard"
+// matches the rest of the path. Lookup is O(path length) and never allocates.
+//
+// Matching priority is fixed per segment, independent of registration order:
+//   1. static segment         ("/users/me")
+//   2. constrained parameter  ("/users/:id(int)"), in registration order
+//   3. parameter              ("/users/:name")
+//   4. wildcard               ("/users/*rest")
+// If a higher-priority branch fails further down the path, lookup backtracks
+// and tries the next branch, so "/users/me/avatar" can still reach
+// "/users/:id/avatar" when only "/users/me" is registered statically.
+class RouteTree {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    RouteTree();
+    ~RouteTree();
+    RouteTree(const RouteTree& other);
+    RouteTree& operator=(const RouteTree& other);
+    RouteTree(RouteTree&&) noexcept;
+    RouteTree& operator=(RouteTree&&) noexcept;
+
+    // Registers pattern -> value. If the same pattern (ignoring parameter
+    // names, not constraints) is already registered, the existing value is
+    // kept and returned; otherwise returns value.
+    std::size_t insert(const RoutePattern& pattern, std::size_t value);
+
+    // Looks up path and fills params on success; returns npos if nothing matches
+    std::size_t find(std::string_view path, RouteParams& params) const;
+
+    std::size_t size() const { return leaves_.size(); }
+
+private:
+    struct Node;
+    struct Leaf {
+        std::size_t value;
+        std::vector<std::string> paramNames; // In capture order
+    };
+
+    bool match(const Node& node, std::string_view path, std::size_t pos,
+               RouteParams& params, std::size_t& leaf) const;
+
+    std::unique_ptr<Node> root_;
+    std::vector<Leaf> leaves_;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_ROUTETREE_H
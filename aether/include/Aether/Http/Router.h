@@ -4,6 +4,7 @@
 
 #include "Request.h"
 #include "Response.h"
+#include "RouteGroup.h"
 #include <string>
 #include <functional>
 
@@ -13,18 +14,24 @@ namespace Http {
 // Forward declaration
 class Server;
 
+// Registers routes under a base path; a thin wrapper over RouteGroup
 class Router {
 private:
-    Server& app;
-    std::string basePath;
+    RouteGroup group_;
 
 public:
-    Router(const std::string& path, Server& server) : basePath(path), app(server) {}
+    Router(const std::string& path, Server& server) : group_(server, path) {}
+
+    // Middleware for routes added through this router from now on
+    void use(Middleware middleware);
 
     void get(const std::string& route, std::function<void(Request&, Response&)> handler);
     void post(const std::string& route, std::function<void(Request&, Response&)> handler);
     void put(const std::string& route, std::function<void(Request&, Response&)> handler);
     void del(const std::string& route, std::function<void(Request&, Response&)> handler);
+    void patch(const std::string& route, std::function<void(Request&, Response&)> handler);
+    void head(const std::string& route, std::function<void(Request&, Response&)> handler);
+    void options(const std::string& route, std::function<void(Request&, Response&)> handler);
 };
 
 } // namespace Http
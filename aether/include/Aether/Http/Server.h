@@ -2,19 +2,22 @@
 #ifndef AETHER_HTTP_SERVER_H
 #define AETHER_HTTP_SERVER_H
 
+#include "Aether/Core/BlockingExecutor.h"
 #include "Aether/Core/EventLoop.h"
+#include "Aether/Http/Connection.h"
 #include "Aether/Http/Request.h"
 #include "Aether/Http/Response.h"
+#include "Aether/Http/Method.h"
 #include "Aether/Http/Middleware.h"
+#include "Aether/Http/Route.h"
+#include "Aether/Http/RouteGroup.h"
 #include "Aether/Http/RoutePattern.h"
+#include "Aether/Http/RouteTemplate.h"
+#include "Aether/Http/RouteTree.h"
 #include "Aether/NeuralDb/NeuralDbServer.h"
-#ifndef BOOST_ERROR_CODE_HEADER_ONLY
-#define BOOST_ERROR_CODE_HEADER_ONLY
-#endif
-#ifndef BOOST_SYSTEM_NO_DEPRECATED
-#define BOOST_SYSTEM_NO_DEPRECATED
-#endif
-#include <boost/asio.hpp>
+#include "Aether/Core/Asio.h"
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
@@ -25,11 +28,8 @@
 namespace Aether {
 namespace Http {
 
-class Connection; // Forward declaration
 class Router; // Forward declaration
 
-using RequestHandler = std::function<void(Request&, Response&)>;
-
 class Server {
 public:
     Server();
@@ -39,13 +39,107 @@ public:
     boost::asio::io_context& ioContext() { return eventLoop_.getIoContext(); }
     
 
-    void get(const std::string& path, RequestHandler handler);
-    void post(const std::string& path, RequestHandler handler);
-    void put(const std::string& path, RequestHandler handler);
-    void del(const std::string& path, RequestHandler handler);
-
+    void get(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    void post(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    void put(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    void del(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    void patch(const std::string& path, RequestHandler handler, RouteOptions options = {});
+
+    // HEAD and OPTIONS are answered automatically: HEAD runs the GET route and
+    // sends its headers without the body, and OPTIONS lists the methods the
+    // path has routes for in an Allow header. Register these to override that.
+    void head(const std::string& path, RequestHandler handler, RouteOptions options = {});
+    void options(const std::string& path, RequestHandler handler, RouteOptions options = {});
+
+    // Registers a route for any method
+    void route(Method method, const std::string& path, RequestHandler handler, RouteOptions options = {});
+
+    // Compile-time route templates (see RouteTemplate): the pattern is
+    // checked when the code is compiled and the handler receives each
+    // parameter already converted to its declared type. A value that does not
+    // convert, such as "abc" for an (int) parameter, gets the same 404 as a
+    // path with no route. The route tree is still built from Pattern by the
+    // runtime RoutePattern parser, once, when the route is registered.
+    //   static constexpr char kPost[] = "/users/:id(int)/posts/:slug";
+    //   server.get<kPost>([](Request& req, Response& res, std::int64_t id, std::string_view slug) { ... });
+    template <const char* Pattern, typename Handler>
+    void get(Handler handler, RouteOptions options = {}) {
+        get(Pattern, RouteTemplate<Pattern>::bind(std::move(handler)), options);
+    }
+
+    template <const char* Pattern, typename Handler>
+    void post(Handler handler, RouteOptions options = {}) {
+        post(Pattern, RouteTemplate<Pattern>::bind(std::move(handler)), options);
+    }
+
+    template <const char* Pattern, typename Handler>
+    void put(Handler handler, RouteOptions options = {}) {
+        put(Pattern, RouteTemplate<Pattern>::bind(std::move(handler)), options);
+    }
+
+    template <const char* Pattern, typename Handler>
+    void del(Handler handler, RouteOptions options = {}) {
+        del(Pattern, RouteTemplate<Pattern>::bind(std::move(handler)), options);
+    }
+
+    template <const char* Pattern, typename Handler>
+    void patch(Handler handler, RouteOptions options = {}) {
+        patch(Pattern, RouteTemplate<Pattern>::bind(std::move(handler)), options);
+    }
+
+    // Middleware for every request. Middleware that only some routes need
+    // belongs on a group (group(prefix).use(...)) or on the route
+    // (RouteOptions::use()), so other routes skip it.
     void use(Middleware middleware);
+
+    // Routes under a shared prefix with their own middleware (see RouteGroup)
+    RouteGroup group(const std::string& prefix);
+
+    // Routes for one hostname, e.g. "shop.example.com", or for every
+    // subdomain of one, "*.example.com" (not example.com itself). Requests are
+    // matched on the Host header, lowercased and without its port: an exact
+    // host first, then the closest wildcard, else the routes registered
+    // directly on the Server. A host with its own routes only uses those.
+    RouteGroup vhost(const std::string& host);
+
     void run(int port);
+    // Makes run() return: stops accepting and joins the I/O threads. Call it
+    // from another thread, not from a handler.
+    void stop();
+
+    // Share-nothing mode: every worker thread gets its own io_context and
+    // SO_REUSEPORT listener, and each accepted connection stays on the worker
+    // that accepted it. workers = 0 picks hardware_concurrency. Call before run().
+    void sharded(std::size_t workers = 0);
+
+    // Zero-copy requests: handlers read req.view (string_views into the read
+    // buffer, valid until the response is sent) and req.view.params, and the
+    // owned method/path/headers/params fields stay empty. Call before run().
+    void zeroCopyRequests(bool enabled = true);
+
+    // Spill request bodies larger than thresholdBytes to an unlinked temp file
+    // in directory (default: the system temp directory) instead of memory.
+    // Handlers read such bodies through req.view.body (a read-only mapping)
+    // or req.bodyFile. Call before run().
+    void spillBodies(std::size_t thresholdBytes, std::string directory = {});
+
+    // Idle keep-alive, request head, request body and write deadlines (see
+    // ConnectionTimeouts). Call before run().
+    void timeouts(const ConnectionTimeouts& timeouts);
+
+    // Thread and queue limits of the executor that runs blocking routes
+    // (RouteOptions::blocking()). Without a call it is created with the
+    // defaults when the first blocking route is registered. Call before
+    // registering routes.
+    void blockingPool(BlockingExecutor::Options options);
+
+    // The executor for blocking routes, for handlers that offload part of
+    // their work themselves (submit() and complete a res.defer() handle)
+    BlockingExecutor& blockingExecutor();
+
+    // Queue depth, wait and run times of the blocking executor; all zero if
+    // it was never created
+    BlockingExecutor::Stats blockingStats() const;
 
     // Start NeuralDB protocol listener
     void neural(int port = 7654);
@@ -54,29 +148,76 @@ public:
     void views(const std::string& folder);
 
 private:
-    struct Route {
-        RoutePattern pattern;
-        RequestHandler handler;
+    // Routes for one method: the tree maps a path to an index into routes.
+    // Snapshots share the Route objects but each has its own copy of the
+    // trees, so publishing costs a copy of the whole table.
+    struct MethodRoutes {
+        RouteTree tree;
+        std::vector<std::shared_ptr<const Route>> routes;
     };
 
-    void startAccept();
+    // Routes of one host, indexed by Method
+    using MethodTable = std::array<MethodRoutes, kMethodCount>;
+
+    // Never modified once published; readers reach it through routes_
+    struct RouteTable {
+        MethodTable routes;                                   // Default host
+        std::unordered_map<std::string, MethodTable> hosts;   // Exact host names
+        std::unordered_map<std::string, MethodTable> domains; // "*.example.com", keyed "example.com"
+    };
+
+    friend class RouteGroup;
+    void addRoute(const std::string& host, Method method, const std::string& path,
+                  RequestHandler handler, RouteOptions options);
+    void publishRoutes();
+
+    // Table for the request's Host header; the default one when no
+    // virtual host matches
+    const MethodTable& hostRoutes(const RouteTable& table, const Request& req) const;
+
+    // Comma-separated methods with a route matching path ("*" for any path),
+    // or empty when there are none
+    std::string allowedMethods(const MethodTable& table, std::string_view path) const;
+
+    void listen(boost::asio::ip::tcp::acceptor& acceptor,
+                const boost::asio::ip::tcp::endpoint& endpoint,
+                bool reusePort);
+    void startAccept(boost::asio::ip::tcp::acceptor& acceptor, std::size_t shard);
     void handleNewConnection(
         const boost::system::error_code& error,
-        std::shared_ptr<boost::asio::ip::tcp::socket> socket
+        boost::asio::ip::tcp::socket socket,
+        boost::asio::io_context& ioContext
     );
 
-    RequestHandler findHandler(const std::string& method, const std::string& path, Request& req);
+    const Route* findRoute(Method method, std::string_view path, Request& req, RoutePin& pin);
+    // Points pin at the current table; null if nothing is published yet
+    const RouteTable* pinRoutes(RoutePin& pin) const;
 
     EventLoop eventLoop_;
-    boost::asio::ip::tcp::acceptor acceptor_;
+    // One listener per shard when SO_REUSEPORT is available, otherwise one
+    // listener that hands sockets to shards round-robin.
+    std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>> acceptors_;
+    std::atomic<std::size_t> nextShard_{0};
     
-    std::mutex handlersMutex_;
-    std::vector<Route> getHandlers_;
-    std::vector<Route> postHandlers_;
-    std::vector<Route> putHandlers_;
-    std::vector<Route> deleteHandlers_;
+    // Route registration is copy-on-write: writers edit draftRoutes_ under
+    // handlersMutex_, publish an immutable copy in routes_ and bump
+    // routesGeneration_. A lookup reads the generation and, while it matches
+    // the connection's RoutePin, uses the pinned table without a lock or a
+    // reference count. After a publish each thread takes handlersMutex_ once
+    // to refresh its cached copy (see pinRoutes()). A superseded table is
+    // freed once no connection or thread cache still holds it.
+    mutable std::mutex handlersMutex_;
+    RouteTable draftRoutes_;
+    std::shared_ptr<const RouteTable> routes_; // Guarded by handlersMutex_
+    std::atomic<std::uint64_t> routesGeneration_{0};
+    Route autoOptions_; // Answers OPTIONS for paths without an OPTIONS route
+
+    // Created on demand under handlersMutex_; routes keep a raw pointer, so
+    // it is never replaced once it exists
+    std::unique_ptr<BlockingExecutor> blocking_;
 
     MiddlewareStack middlewareStack_;
+    ConnectionOptions connectionOptions_;
     std::atomic<int> activeConnections_{0};
     static constexpr int maxConnections_{10000};
 
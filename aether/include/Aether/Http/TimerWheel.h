@@ -0,0 +1,142 @@
+// File: Aether/Http/TimerWheel.h
+#ifndef AETHER_HTTP_TIMER_WHEEL_H
+#define AETHER_HTTP_TIMER_WHEEL_H
+
+#include "Aether/Core/Asio.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Aether {
+namespace Http {
+
+// Hierarchical timing wheel counting in abstract ticks. Entries are intrusive
+// list nodes owned by the caller, so scheduling, rescheduling and cancelling
+// are O(1) and never allocate. Level n has kSlots slots of kSlots^n ticks
+// each; an entry sits on the level its distance falls in and moves down a
+// level each time the wheel reaches its slot. Not thread-safe.
+class TimerWheel {
+public:
+    static constexpr unsigned kLevelBits = 6;
+    static constexpr std::size_t kSlots = std::size_t{1} << kLevelBits;
+    static constexpr std::size_t kLevels = 4; // 64^4 ticks ahead; farther entries wait in the last level
+
+    class Entry {
+    public:
+        Entry() = default;
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        bool scheduled() const { return next_ != nullptr; }
+        std::uint64_t expiry() const { return expiry_; }
+
+        // Called (by the owner of the wheel) once the entry expires
+        std::function<void()> onExpire;
+
+    private:
+        friend class TimerWheel;
+        Entry* prev_ = nullptr;
+        Entry* next_ = nullptr;
+        std::uint64_t expiry_ = 0;
+    };
+
+    TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    ~TimerWheel() { clear(); }
+
+    std::uint64_t now() const { return now_; }
+    std::size_t size() const { return size_; }
+
+    // (Re)schedules entry to expire at tick expiry; one in the past expires
+    // on the next tick
+    void schedule(Entry& entry, std::uint64_t expiry);
+    void cancel(Entry& entry);
+
+    // Moves the wheel to tick to, unlinking each entry that expires on the
+    // way and passing it to expired
+    template <typename Callback>
+    void advance(std::uint64_t to, Callback&& expired) {
+        if (size_ == 0) {
+            now_ = std::max(now_, to); // Nothing to visit on the way
+            return;
+        }
+        while (now_ < to) {
+            ++now_;
+            // Entries due within the next level's span move down before the
+            // level 0 slot for this tick is emptied
+            for (std::size_t level = 1; level < kLevels && slotIndex(now_, level - 1) == 0; ++level) {
+                cascade(level);
+            }
+            Entry& head = slots_[0][slotIndex(now_, 0)];
+            while (head.next_ != &head) {
+                Entry& entry = *head.next_;
+                unlink(entry);
+                if (entry.expiry_ > now_) {
+                    link(entry); // Waited in the last level; not due yet
+                    continue;
+                }
+                expired(entry);
+            }
+            if (size_ == 0) {
+                now_ = to;
+            }
+        }
+    }
+
+    // Unschedules every entry
+    void clear();
+
+private:
+    static std::size_t slotIndex(std::uint64_t tick, std::size_t level) {
+        return static_cast<std::size_t>(tick >> (level * kLevelBits)) & (kSlots - 1);
+    }
+
+    void link(Entry& entry);
+    void unlink(Entry& entry);
+    void cascade(std::size_t level);
+
+    // Each slot is a circular list with the array element as its sentinel
+    std::array<std::array<Entry, kSlots>, kLevels> slots_;
+    std::uint64_t now_ = 0;
+    std::size_t size_ = 0;
+};
+
+// A TimerWheel per io_context, driven by one steady_timer that only runs
+// while something is scheduled. Connections share it instead of keeping an
+// Asio timer each, so a re-armed deadline is a list splice rather than a
+// cancelled wait plus a new one. It takes no lock: use it only with an
+// io_context that a single thread runs, such as a shard, and only from that
+// thread. Deadlines are rounded up to kResolution and never fire early.
+// Callbacks run from the service's timer handler; an entry must be
+// cancelled before it is destroyed.
+//   auto& timers = boost::asio::use_service<TimerService>(shardContext);
+class TimerService : public boost::asio::io_context::service {
+public:
+    static boost::asio::io_context::id id;
+    static constexpr std::chrono::milliseconds kResolution{100};
+
+    explicit TimerService(boost::asio::io_context& context);
+
+    void schedule(TimerWheel::Entry& entry, std::chrono::milliseconds delay);
+    void cancel(TimerWheel::Entry& entry);
+    std::size_t size();
+
+private:
+    void shutdown() override;
+    void startTicking();
+    void onTick();
+    std::uint64_t ticksSinceStart() const;
+
+    TimerWheel wheel_;
+    boost::asio::steady_timer timer_;
+    std::chrono::steady_clock::time_point start_;
+    bool ticking_ = false;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_TIMER_WHEEL_H
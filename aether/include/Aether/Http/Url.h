@@ -0,0 +1,76 @@
+// File: Aether/Http/Url.h
+#ifndef AETHER_HTTP_URL_H
+#define AETHER_HTTP_URL_H
+
+#include <charconv>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Aether {
+namespace Http {
+
+// Percent-decodes a request path into out. "%2F" is left encoded so that an
+// encoded slash never splits a path segment. Returns false for a malformed
+// escape or an encoded NUL.
+bool decodePath(std::string_view path, std::string& out);
+
+// Decodes a query string key or value ("+" is a space) and appends it to out.
+// Malformed escapes are kept as they are.
+void decodeQueryComponent(std::string_view component, std::string& out);
+
+// Parses text as a whole number or floating point value with from_chars;
+// empty if any of it is left over
+template <typename T>
+std::optional<T> parseNumber(std::string_view text) {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "parseNumber() reads integral and floating point types");
+    T value{};
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    if (!text.empty() && *begin == '+') {
+        ++begin; // from_chars does not take a leading '+'
+    }
+    const auto [ptr, ec] = std::from_chars(begin, end, value);
+    if (ec != std::errc() || ptr != end || begin == end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// Query parameters, split and decoded the first time one is asked for.
+// Values are views into the raw query, or into a buffer of decoded bytes
+// owned here when they had to be decoded. Copies start out unparsed, so they
+// never point into another request.
+class QueryParams {
+public:
+    using Param = std::pair<std::string_view, std::string_view>;
+
+    QueryParams() = default;
+    QueryParams(const QueryParams&) {}
+    QueryParams(QueryParams&&) noexcept {}
+    QueryParams& operator=(const QueryParams&) { clear(); return *this; }
+    QueryParams& operator=(QueryParams&&) noexcept { clear(); return *this; }
+
+    // Parameters of raw (the part after '?'), in order; parses once
+    const std::vector<Param>& parse(std::string_view raw);
+
+    void clear() {
+        params_.clear();
+        decoded_.clear();
+        parsed_ = false;
+    }
+
+private:
+    std::vector<Param> params_;
+    std::string decoded_; // Sized up front; never reallocates while views point into it
+    bool parsed_ = false;
+};
+
+} // namespace Http
+} // namespace Aether
+
+#endif // AETHER_HTTP_URL_H
@@ -17,6 +17,7 @@
 #include "Aether/Http/HttpParser.h"
 #include "Aether/Http/Connection.h"
 #include "Aether/Http/Middleware.h"
+#include "Aether/Http/Multipart.h"
 
 // Middleware components
 #include "Aether/Middleware/ServeStatic.h"
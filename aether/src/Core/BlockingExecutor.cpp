@@ -0,0 +1,98 @@
+#include "Aether/Core/BlockingExecutor.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <utility>
+
+namespace Aether {
+
+namespace {
+thread_local bool poolThread = false;
+}
+
+BlockingExecutor::BlockingExecutor(Options options)
+    : maxQueue_(options.maxQueue) {
+    std::size_t numThreads = options.threads;
+    if (numThreads == 0) {
+        numThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    threads_.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; ++i) {
+        threads_.emplace_back([this] { work(); });
+    }
+}
+
+BlockingExecutor::~BlockingExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+bool BlockingExecutor::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= maxQueue_) {
+            ++stats_.rejected;
+            return false;
+        }
+        queue_.push_back({std::move(task), Clock::now()});
+        ++stats_.submitted;
+        stats_.queueDepth = queue_.size();
+        stats_.peakQueueDepth = std::max(stats_.peakQueueDepth, queue_.size());
+    }
+    ready_.notify_one();
+    return true;
+}
+
+BlockingExecutor::Stats BlockingExecutor::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool BlockingExecutor::onPoolThread() {
+    return poolThread;
+}
+
+void BlockingExecutor::work() {
+    poolThread = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return; // Stopping, and everything queued has run
+        }
+
+        Task task = std::move(queue_.front());
+        queue_.pop_front();
+        const auto started = Clock::now();
+        const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(started - task.queuedAt);
+        stats_.queueDepth = queue_.size();
+        stats_.totalWait += waited;
+        stats_.maxWait = std::max(stats_.maxWait, waited);
+        ++stats_.running;
+        lock.unlock();
+
+        try {
+            task.run();
+        } catch (const std::exception& e) {
+            std::cerr << "Blocking task error: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Blocking task error: unknown exception" << std::endl;
+        }
+        task.run = nullptr; // Release captures before taking the lock again
+
+        const auto ran = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started);
+        lock.lock();
+        --stats_.running;
+        ++stats_.completed;
+        stats_.totalRun += ran;
+    }
+}
+
+} // namespace Aether
@@ -4,11 +4,35 @@
 
 namespace Aether {
 
-EventLoop::EventLoop()
-    : ioContext_(std::make_unique<boost::asio::io_context>()),
-      workGuard_(std::make_unique<boost::asio::executor_work_guard<
-          boost::asio::io_context::executor_type>>(
-              boost::asio::make_work_guard(*ioContext_))) {}
+namespace {
+
+std::size_t defaultThreadCount() {
+    std::size_t numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    return numThreads;
+}
+
+} // anonymous namespace
+
+const char* EventLoop::ioBackend() {
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL)
+    return "io_uring";
+#elif defined(BOOST_ASIO_HAS_EPOLL)
+    return "epoll";
+#elif defined(BOOST_ASIO_HAS_KQUEUE)
+    return "kqueue";
+#elif defined(BOOST_ASIO_HAS_IOCP)
+    return "iocp";
+#else
+    return "select";
+#endif
+}
+
+EventLoop::EventLoop() {
+    ioContexts_.push_back(std::make_unique<boost::asio::io_context>());
+}
 
 EventLoop::~EventLoop() {
     stop();
@@ -19,18 +43,45 @@ void EventLoop::start() {
         return;
     }
 
+    sharded_ = false;
+    launch(defaultThreadCount(), 1);
+}
+
+void EventLoop::startSharded(std::size_t numShards) {
+    if (running_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    if (numShards == 0) {
+        numShards = defaultThreadCount();
+    }
+
+    while (ioContexts_.size() < numShards) {
+        // Concurrency hint 1: each shard is only ever run by one thread, which
+        // lets Asio's scheduler take its single-threaded fast paths.
+        ioContexts_.push_back(std::make_unique<boost::asio::io_context>(1));
+    }
+
+    sharded_ = true;
+    launch(numShards, numShards);
+}
+
+void EventLoop::launch(std::size_t numThreads, std::size_t numShards) {
     running_.store(true, std::memory_order_release);
+    activeShards_ = numShards;
 
-    std::size_t numThreads = std::thread::hardware_concurrency();
-    if (numThreads == 0) {
-        numThreads = 1;
+    workGuards_.clear();
+    for (std::size_t i = 0; i < numShards; ++i) {
+        workGuards_.push_back(std::make_unique<WorkGuard>(
+            boost::asio::make_work_guard(*ioContexts_[i])));
     }
 
     threads_.reserve(numThreads);
     for (std::size_t i = 0; i < numThreads; ++i) {
-        threads_.emplace_back([this] {
-            // Each thread runs the io_context loop until stopped
-            ioContext_->run();
+        boost::asio::io_context& ioContext = *ioContexts_[i % numShards];
+        threads_.emplace_back([&ioContext] {
+            // Each thread runs its io_context loop until stopped
+            ioContext.run();
         });
     }
 }
@@ -43,8 +94,10 @@ void EventLoop::stop() {
     running_.store(false, std::memory_order_release);
 
     // Allow io_context::run() to return
-    workGuard_.reset();
-    ioContext_->stop();
+    workGuards_.clear();
+    for (std::size_t i = 0; i < activeShards_; ++i) {
+        ioContexts_[i]->stop();
+    }
 
     // Join all worker threads
     for (auto& thread : threads_) {
@@ -54,17 +107,16 @@ void EventLoop::stop() {
     }
     threads_.clear();
 
-    // Reset io_context so it can be restarted if needed
-    ioContext_->restart();
-    workGuard_ = std::make_unique<boost::asio::executor_work_guard<
-        boost::asio::io_context::executor_type>>(
-            boost::asio::make_work_guard(*ioContext_));
+    // Reset io_contexts so they can be restarted if needed
+    for (std::size_t i = 0; i < activeShards_; ++i) {
+        ioContexts_[i]->restart();
+    }
 }
 
 void EventLoop::post(std::function<void()> task) {
     // Legacy overload – still uses std::function, but many call sites
     // can be migrated to the templated post() for better performance.
-    boost::asio::post(*ioContext_, std::move(task));
+    boost::asio::post(*ioContexts_.front(), std::move(task));
 }
 
 void EventLoop::keepAlive() {
@@ -76,7 +128,11 @@ void EventLoop::keepAlive() {
 }
 
 boost::asio::io_context& EventLoop::getIoContext() {
-    return *ioContext_;
+    return *ioContexts_.front();
+}
+
+boost::asio::io_context& EventLoop::getIoContext(std::size_t shard) {
+    return *ioContexts_[shard % activeShards_];
 }
 
 } // namespace Aether
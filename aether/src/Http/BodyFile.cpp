@@ -0,0 +1,74 @@
+// File: Aether/Http/BodyFile.cpp
+#include "Aether/Http/BodyFile.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+[[noreturn]] void throwErrno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // anonymous namespace
+
+BodyFile::BodyFile(const std::string& directory) {
+#ifdef O_TMPFILE
+    // Never has a name at all where the filesystem supports it
+    fd_ = ::open(directory.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+#endif
+    if (fd_ < 0) {
+        std::string path = directory + "/aether-body-XXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        fd_ = ::mkstemp(name.data());
+        if (fd_ < 0) {
+            throwErrno("Cannot create request body file");
+        }
+        ::unlink(name.data());
+    }
+}
+
+BodyFile::~BodyFile() {
+    if (mapping_) {
+        ::munmap(const_cast<char*>(mapping_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void BodyFile::append(std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t written = ::write(fd_, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwErrno("Cannot write request body file");
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+        size_ += static_cast<std::size_t>(written);
+    }
+}
+
+void BodyFile::seal() {
+    if (mapping_ || size_ == 0) {
+        return; // An empty file cannot be mapped; data() is then empty
+    }
+    void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        throwErrno("Cannot map request body file");
+    }
+    mapping_ = static_cast<const char*>(mapped);
+}
+
+} // namespace Http
+} // namespace Aether
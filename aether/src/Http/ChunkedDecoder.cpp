@@ -0,0 +1,176 @@
+// File: Aether/Http/ChunkedDecoder.cpp
+#include "Aether/Http/ChunkedDecoder.h"
+#include <algorithm>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // anonymous namespace
+
+void ChunkedDecoder::reset(std::size_t maxBodyBytes) {
+    state_ = State::Size;
+    chunkRemaining_ = 0;
+    lineBytes_ = 0;
+    trailerBytes_ = 0;
+    bodyBytes_ = 0;
+    maxBodyBytes_ = maxBodyBytes;
+    sawDigit_ = false;
+}
+
+ChunkedDecoder::Status ChunkedDecoder::decode(std::string_view input, std::size_t& consumed,
+                                              std::string_view& data) {
+    std::size_t pos = 0;
+    const auto finish = [&](Status status) {
+        consumed = pos;
+        if (status == Status::Invalid || status == Status::TooLarge) {
+            state_ = State::Failed;
+        }
+        return status;
+    };
+
+    while (pos < input.size()) {
+        if (state_ == State::Data) {
+            // Hand back as much of the chunk as is here, without copying it
+            const std::size_t take = std::min(chunkRemaining_, input.size() - pos);
+            data = input.substr(pos, take);
+            pos += take;
+            chunkRemaining_ -= take;
+            bodyBytes_ += take;
+            if (chunkRemaining_ == 0) {
+                state_ = State::DataCR;
+            }
+            return finish(Status::Data);
+        }
+
+        const char c = input[pos++];
+        switch (state_) {
+        case State::Size: {
+            const int digit = hexValue(c);
+            if (digit >= 0) {
+                if (chunkRemaining_ > (std::numeric_limits<std::size_t>::max() >> 4)) {
+                    return finish(Status::TooLarge);
+                }
+                chunkRemaining_ = (chunkRemaining_ << 4) | static_cast<std::size_t>(digit);
+                sawDigit_ = true;
+                break;
+            }
+            if (!sawDigit_) {
+                return finish(Status::Invalid);
+            }
+            state_ = State::SizeEnd;
+            --pos; // Look at this byte again as the end of the size
+            break;
+        }
+        case State::SizeEnd:
+            // Optional whitespace, then extensions or the end of the line
+            if (c == ';') {
+                state_ = State::Extension;
+            } else if (c == '\r') {
+                state_ = State::SizeLF;
+            } else if (c != ' ' && c != '\t') {
+                return finish(Status::Invalid);
+            }
+            break;
+        case State::Extension:
+            // Extensions are accepted and ignored; a bare LF is not a line end
+            if (c == '\r') {
+                state_ = State::SizeLF;
+            } else if (c == '\n') {
+                return finish(Status::Invalid);
+            }
+            break;
+        case State::SizeLF:
+            if (c != '\n') {
+                return finish(Status::Invalid);
+            }
+            if (chunkRemaining_ == 0) {
+                state_ = State::TrailerStart;
+                break;
+            }
+            if (chunkRemaining_ > maxBodyBytes_ || bodyBytes_ > maxBodyBytes_ - chunkRemaining_) {
+                return finish(Status::TooLarge);
+            }
+            state_ = State::Data;
+            break;
+        case State::DataCR:
+            if (c != '\r') {
+                return finish(Status::Invalid);
+            }
+            state_ = State::DataLF;
+            break;
+        case State::DataLF:
+            if (c != '\n') {
+                return finish(Status::Invalid);
+            }
+            state_ = State::Size;
+            lineBytes_ = 0;
+            sawDigit_ = false;
+            continue; // The size line starts fresh
+        case State::TrailerStart:
+            // A blank line ends the message; anything else is a trailer field
+            if (c == '\n') {
+                return finish(Status::Invalid);
+            }
+            state_ = c == '\r' ? State::FinalLF : State::Trailer;
+            break;
+        case State::Trailer:
+            if (c == '\r') {
+                state_ = State::TrailerLF;
+            } else if (c == '\n') {
+                return finish(Status::Invalid);
+            }
+            break;
+        case State::TrailerLF:
+            if (c != '\n') {
+                return finish(Status::Invalid);
+            }
+            state_ = State::TrailerStart;
+            break;
+        case State::FinalLF:
+            if (c != '\n') {
+                return finish(Status::Invalid);
+            }
+            state_ = State::Done;
+            return finish(Status::Done);
+        case State::Done:
+            --pos; // Not part of this body
+            return finish(Status::Done);
+        case State::Failed:
+            --pos;
+            return finish(Status::Invalid);
+        case State::Data:
+            break; // Handled above
+        }
+
+        if (state_ == State::Size || state_ == State::SizeEnd ||
+            state_ == State::Extension || state_ == State::SizeLF) {
+            if (++lineBytes_ > kMaxLineBytes) {
+                return finish(Status::Invalid);
+            }
+        } else if (state_ >= State::TrailerStart && state_ <= State::FinalLF) {
+            if (++trailerBytes_ > kMaxTrailerBytes) {
+                return finish(Status::Invalid);
+            }
+        }
+    }
+
+    if (state_ == State::Done) {
+        return finish(Status::Done);
+    }
+    if (state_ == State::Failed) {
+        return finish(Status::Invalid);
+    }
+    return finish(Status::NeedMore);
+}
+
+} // namespace Http
+} // namespace Aether
@@ -1,8 +1,13 @@
 #include "Aether/Http/Connection.h"
+#include "Aether/Core/BlockingExecutor.h"
+#include "Aether/Http/HttpDate.h"
 #include "Aether/Http/HttpParser.h"
 #include <iostream>
 #include <cctype>
+#include <charconv>
 #include <chrono>
+#include <limits>
+#include <utility>
 
 namespace Aether {
 namespace Http {
@@ -11,110 +16,322 @@ Connection::Connection(
     boost::asio::ip::tcp::socket socket,
     HandlerLookup handlerLookup,
     MiddlewareStack& middlewareStack,
-    std::function<void()> cleanupCallback
+    std::function<void()> cleanupCallback,
+    TimerService* timers,
+    ConnectionOptions options
 )
     : socket_(std::move(socket)),
+      timers_(timers),
       timeoutTimer_(socket_.get_executor()),
       handlerLookup_(std::move(handlerLookup)),
       middlewareStack_(middlewareStack),
       cleanupCallback_(std::move(cleanupCallback)),
+      options_(options),
       requestBuffer_(),
       responseData_(),
       req_(),
       res_(),
       isClosed_(false),
       totalBodyBytes_(0) {
+    req_.zeroCopy(options_.zeroCopyRequests);
     boost::system::error_code ec;
     socket_.set_option(boost::asio::ip::tcp::no_delay(true), ec);
 }
 
+Connection::~Connection() {
+    if (timers_) {
+        timers_->cancel(timeout_);
+    }
+}
+
 void Connection::start() {
-    resetTimeout();
+    // The wheel fires from its own timer handler; close on our own executor
+    timeout_.onExpire = [weak = weak_from_this(), executor = executor()]() {
+        boost::asio::post(executor, [weak]() {
+            if (auto self = weak.lock()) {
+                self->closeConnection();
+            }
+        });
+    };
     requestBuffer_.clear();
-    req_ = Request{};
+    parseOffset_ = 0;
+    readNextRequest();
+}
+
+void Connection::readNextRequest() {
+    // The previous request's views die here, so leftover bytes from a chunked
+    // body can now be moved back in front of the next request
+    req_.clear();
     res_ = Response{};
+    res_.stream_ = this;
     totalBodyBytes_ = 0;
+    contentLength_ = 0;
+    scannedLength_ = 0;
+    route_ = nullptr;
+    streamingBody_ = false;
+    bodyUnread_ = false;
+    if (!chunkBuffer_.empty()) {
+        requestBuffer_.erase(0, parseOffset_);
+        parseOffset_ = 0;
+        requestBuffer_.append(chunkBuffer_);
+        chunkBuffer_.clear();
+    }
 
-    boost::asio::async_read_until(
-        socket_,
-        boost::asio::dynamic_buffer(requestBuffer_),
-        "\r\n\r\n",
-        [self = shared_from_this()](auto error, auto bytes) {
-            self->handleReadHeaders(error, bytes);
-        }
-    );
+    parseBufferedRequest();
 }
 
-void Connection::handleReadHeaders(
-    const boost::system::error_code& error,
-    std::size_t bytes_transferred
-) {
-    if (error) {
-        handleNetworkError(error);
+void Connection::parseBufferedRequest() {
+    // Pipelined requests sit back to back in requestBuffer_; parseOffset_ is
+    // where the next one starts
+    const std::string_view pending(requestBuffer_.data() + parseOffset_,
+                                   requestBuffer_.size() - parseOffset_);
+    std::size_t headLength = 0;
+    const auto parsed = options_.zeroCopyRequests
+        ? HttpParser::parseRequestHead(pending, req_.view, headLength, scannedLength_)
+        : HttpParser::parseRequestHead(pending, req_, headLength, scannedLength_);
+
+    if (parsed == HttpParser::ParseResult::Complete) {
+        handleRequestHead(headLength);
         return;
     }
-
-    // bytes_transferred is the number of bytes up to and including "\r\n\r\n".
-    // There may already be some body bytes after that in requestBuffer_.
-    if (bytes_transferred > requestBuffer_.size()) {
-        // Should not happen, but guard anyway.
+    if (parsed == HttpParser::ParseResult::Invalid) {
         sendError(400);
         return;
     }
-
-    // Parse request line + headers only from the header portion.
-    std::string_view headerView(requestBuffer_.data(), bytes_transferred);
-    if (!HttpParser::parseRequest(headerView, req_)) {
-        sendError(400);
+    if (pending.size() > kMaxHeadBytes) {
+        sendError(431);
         return;
     }
 
-    // Extract any body bytes that arrived in the same read as the headers.
-    const std::size_t extraBodyBytes = requestBuffer_.size() - bytes_transferred;
-    if (extraBodyBytes > 0) {
-        req_.body.assign(
-            requestBuffer_.data() + bytes_transferred,
-            extraBodyBytes
-        );
-        totalBodyBytes_ = extraBodyBytes;
-    } else {
-        req_.body.clear();
-        totalBodyBytes_ = 0;
+    scannedLength_ = pending.size();
+    // Out of complete requests: send the batch before waiting on the client
+    flushResponses([this]() { readMore(); });
+}
+
+void Connection::readMore() {
+    // Answered requests are no longer referenced; drop them so the buffer
+    // only ever holds the request being assembled
+    if (parseOffset_ > 0) {
+        requestBuffer_.erase(0, parseOffset_);
+        parseOffset_ = 0;
     }
 
-    // We no longer need the header bytes in requestBuffer_.
-    requestBuffer_.clear();
+    // Waiting for a new request, or for the rest of one whose head has
+    // started: that deadline is not pushed back by each trickle of bytes
+    armTimeout(requestBuffer_.empty() ? Phase::Idle : Phase::Header);
+
+    const std::size_t used = requestBuffer_.size();
+    requestBuffer_.resize(used + kReadChunkBytes);
+    socket_.async_read_some(
+        boost::asio::buffer(&requestBuffer_[used], kReadChunkBytes),
+        [self = shared_from_this(), used](auto error, std::size_t bytes) {
+            self->requestBuffer_.resize(used + bytes);
+            if (error) {
+                self->handleNetworkError(error);
+                return;
+            }
+            self->parseBufferedRequest();
+        }
+    );
+}
+
+void Connection::handleRequestHead(std::size_t headLength) {
+    clearTimeout(); // The head is in; the next wait starts its own
 
     // Validate Host header (required for HTTP/1.1)
-    const auto hostIt = req_.headers.find("host");
-    if (req_.version == "HTTP/1.1" && hostIt == req_.headers.end()) {
+    if (req_.view.version == "HTTP/1.1" && !req_.view.hasHeader(KnownHeader::Host)) {
         sendError(400); // Bad Request: Host header is required
         return;
     }
 
-    // Handle Expect: 100-continue
-    auto expectIt = req_.headers.find("expect");
-    if (expectIt != req_.headers.end() && iequals(expectIt->second, "100-continue")) {
-        send100Continue();
-        return; // Wait for the client to send the body
+    // Route on the decoded path. Owned requests were decoded by the parser;
+    // zero-copy ones decode into decodedPath_ only when there is an escape.
+    if (req_.view.path.find('%') != std::string_view::npos) {
+        if (!options_.zeroCopyRequests) {
+            req_.view.path = req_.path;
+        } else if (decodePath(req_.view.path, decodedPath_)) {
+            req_.view.path = decodedPath_;
+        } else {
+            sendError(400);
+            return;
+        }
+    }
+
+    // A length next to a transfer coding could be read either way by a proxy
+    // in front of us (request smuggling), so that is refused outright
+    const bool hasBody = req_.view.hasHeader(KnownHeader::ContentLength);
+    const bool chunked = req_.view.hasHeader(KnownHeader::TransferEncoding);
+    if (chunked) {
+        const int status = hasBody ? 400 : transferEncodingStatus(req_.view.header(KnownHeader::TransferEncoding));
+        if (status != 0) {
+            sendError(status);
+            return;
+        }
+    }
+
+    // Route on the head alone, so the route's body options apply before any
+    // of the body is read
+    route_ = handlerLookup_(req_.view.methodId, req_.view.path, req_, routePin_);
+    streamingBody_ = route_ && route_->options.streamBody;
+    if (route_ && route_->options.maxBodyBytes > 0) {
+        bodyLimit_ = route_->options.maxBodyBytes;
+    } else {
+        bodyLimit_ = streamingBody_ ? std::numeric_limits<std::size_t>::max() : kMaxBodySizeBytes;
     }
 
-    // Handle request body
-    const bool hasBody = req_.headers.count("content-length");
-    const bool chunked = req_.headers.count("transfer-encoding") &&
-                         iequals(req_.headers.at("transfer-encoding"), "chunked");
+    if (hasBody) {
+        const std::string_view value = req_.view.header(KnownHeader::ContentLength);
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), contentLength_);
+        if (ec != std::errc() || end != value.data() + value.size() || value.empty()) {
+            sendError(400);
+            return;
+        }
+        if (exceedsBodyLimit(0, contentLength_, bodyLimit_)) {
+            sendError(413); // Payload Too Large, before any 100 Continue
+            return;
+        }
+    }
+
+    if (streamingBody_ && !startStreamedRequest(hasBody || chunked)) {
+        return;
+    }
+
+    // Body bytes that arrived with the head. The head itself stays put in
+    // requestBuffer_, so req_.view remains valid until the response is built.
+    const std::size_t headEnd = parseOffset_ + headLength;
+    const std::string_view buffered(requestBuffer_.data() + headEnd,
+                                    requestBuffer_.size() - headEnd);
 
     if (hasBody) {
-        handleContentLengthBody();
+        if (!streamingBody_ && options_.spillThresholdBytes > 0 &&
+            contentLength_ > options_.spillThresholdBytes && !spillBody()) {
+            return;
+        }
+
+        const std::size_t inBuffer = std::min<std::size_t>(buffered.size(), contentLength_);
+        if (streamingBody_ || req_.bodyFile) {
+            if (inBuffer > 0 && !deliverBody(buffered.substr(0, inBuffer))) {
+                return;
+            }
+        } else if (inBuffer == contentLength_ && options_.zeroCopyRequests) {
+            req_.view.body = buffered.substr(0, contentLength_);
+        } else {
+            req_.body.assign(buffered.data(), inBuffer);
+        }
+        totalBodyBytes_ = inBuffer;
+
+        if (inBuffer == contentLength_) {
+            // Whole body is here; whatever follows is the next request
+            parseOffset_ = headEnd + contentLength_;
+            processRequest();
+            return;
+        }
     } else if (chunked) {
-        handleChunkedBody();
+        // Decode the part of the body that came with the head in place; a
+        // body that is all here is answered without another read
+        chunkDecoder_.reset(bodyLimit_);
+        std::size_t consumed = 0;
+        const auto status = decodeChunks(buffered, consumed);
+        if (status == ChunkedDecoder::Status::Done) {
+            parseOffset_ = headEnd + consumed;
+            processRequest();
+            return;
+        }
+        if (status != ChunkedDecoder::Status::NeedMore) {
+            return; // Already answered
+        }
     } else {
+        parseOffset_ = headEnd;
         processRequest(); // No body: process immediately
+        return;
     }
+    parseOffset_ = requestBuffer_.size();
+
+    // The rest of the body is still on the wire: answer earlier pipelined
+    // requests before asking for it
+    flushResponses([this]() {
+        if (iequals(req_.view.header(KnownHeader::Expect), "100-continue")) {
+            send100Continue();
+        } else {
+            handleRequestBody();
+        }
+    });
+}
+
+bool Connection::spillBody() {
+    try {
+        req_.bodyFile = std::make_shared<BodyFile>(options_.spillDirectory);
+        req_.bodyFile->append(req_.body); // Whatever was buffered so far
+    } catch (const std::exception& e) {
+        std::cerr << "Request body error: " << e.what() << std::endl;
+        sendError(500);
+        return false;
+    }
+    req_.body.clear();
+    req_.body.shrink_to_fit();
+    return true;
+}
+
+bool Connection::startStreamedRequest(bool hasBody) {
+    // The handler runs before the body is read and subscribes to it with
+    // req.onData()/req.onEnd(). Its hold lasts until processRequest() has
+    // run onEnd.
+    handlerStarted_ = false;
+    hold();
+    try {
+        middlewareStack_.run(req_, res_, [this]() {
+            runRoute(*route_);
+        });
+    } catch (...) {
+        release(std::current_exception());
+        return false;
+    }
+    if (handlerStarted_) {
+        return true;
+    }
+
+    // Middleware answered on its own (e.g. refused authentication): reply
+    // right away without reading, or acknowledging, the body
+    bodyUnread_ = hasBody;
+    release();
+    return false;
+}
+
+bool Connection::deliverBody(std::string_view data) {
+    if (!streamingBody_) {
+        if (!req_.bodyFile && options_.spillThresholdBytes > 0 &&
+            req_.body.size() + data.size() > options_.spillThresholdBytes && !spillBody()) {
+            return false;
+        }
+        if (!req_.bodyFile) {
+            req_.body.append(data.data(), data.size());
+            return true;
+        }
+        try {
+            req_.bodyFile->append(data); // Page-cache write; does not wait for the disk
+        } catch (const std::exception& e) {
+            std::cerr << "Request body error: " << e.what() << std::endl;
+            sendError(500);
+            return false;
+        }
+        return true;
+    }
+    if (!req_.onData_) {
+        return true; // The handler did not ask for the body; drop it
+    }
+    try {
+        req_.onData_(data);
+    } catch (const std::exception& e) {
+        std::cerr << "Processing error: " << e.what() << std::endl;
+        sendError(500);
+        return false;
+    }
+    return true;
 }
 
 void Connection::send100Continue() {
     static const std::string continueResponse = "HTTP/1.1 100 Continue\r\n\r\n";
+    armTimeout(Phase::Write);
     boost::asio::async_write(
         socket_,
         boost::asio::buffer(continueResponse),
@@ -130,180 +347,406 @@ void Connection::send100Continue() {
 }
 
 void Connection::handleRequestBody() {
-    const bool hasBody = req_.headers.count("content-length");
-    const bool chunked = req_.headers.count("transfer-encoding") &&
-                         iequals(req_.headers.at("transfer-encoding"), "chunked");
-
-    if (hasBody) {
-        handleContentLengthBody(); // Start reading the body
-    } else if (chunked) {
-        handleChunkedBody(); // Start reading the chunked body
+    if (!req_.view.hasHeader(KnownHeader::ContentLength)) {
+        readChunkedBody(); // Start reading the chunked body
+    } else if (streamingBody_ || req_.bodyFile) {
+        readStreamedBody(); // Streamed or spilled: pieces through bodyBuffer_
     } else {
-        processRequest(); // No body, process the request
+        handleContentLengthBody(); // Start reading the body
     }
 }
 
 void Connection::handleContentLengthBody() {
-    try {
-        const auto& headerVal = req_.headers.at("content-length");
-        const std::size_t content_length = std::stoull(headerVal);
+    // Read no further than the missing bytes, straight into the end of
+    // req_.body, so nothing belonging to a pipelined request is consumed here.
+    // Each read that makes progress pushes the body timeout back.
+    armTimeout(Phase::Body);
+    req_.body.resize(contentLength_);
+    socket_.async_read_some(
+        boost::asio::buffer(&req_.body[totalBodyBytes_], contentLength_ - totalBodyBytes_),
+        [self = shared_from_this()](auto error, std::size_t bytes) {
+            if (error) {
+                self->handleNetworkError(error);
+                return;
+            }
 
-        // totalBodyBytes_ currently includes any bytes that arrived with headers
-        if (totalBodyBytes_ > content_length) {
-            sendError(400);
-            return;
+            self->totalBodyBytes_ += bytes;
+            if (self->totalBodyBytes_ < self->contentLength_) {
+                self->handleContentLengthBody();
+            } else {
+                self->processRequest();
+            }
         }
+    );
+}
 
-        const std::size_t remaining = content_length - totalBodyBytes_;
+void Connection::readStreamedBody() {
+    // Streamed bodies pass through a bounded buffer, one piece at a time
+    const std::size_t want = std::min(contentLength_ - totalBodyBytes_, kStreamBodyReadBytes);
+    armTimeout(Phase::Body);
+    bodyBuffer_.resize(want);
+    socket_.async_read_some(
+        boost::asio::buffer(&bodyBuffer_[0], want),
+        [self = shared_from_this()](auto error, std::size_t bytes) {
+            if (error) {
+                self->handleNetworkError(error);
+                return;
+            }
 
-        if (exceedsBodyLimit(totalBodyBytes_, remaining)) {
-            sendError(413); // Payload Too Large
-            return;
+            self->totalBodyBytes_ += bytes;
+            if (!self->deliverBody(std::string_view(self->bodyBuffer_.data(), bytes))) {
+                return;
+            }
+            if (self->totalBodyBytes_ < self->contentLength_) {
+                self->readStreamedBody();
+            } else {
+                self->processRequest();
+            }
         }
+    );
+}
 
-        if (remaining > 0) {
-            // Read exactly the remaining bytes into requestBuffer_, then append to req_.body
-            boost::asio::async_read(
-                socket_,
-                boost::asio::dynamic_buffer(requestBuffer_),
-                boost::asio::transfer_exactly(remaining),
-                [self = shared_from_this(), remaining](auto error, auto) {
-                    if (error) {
-                        self->handleNetworkError(error);
-                        return;
-                    }
-
-                    // Append newly read body bytes
-                    self->req_.body.append(self->requestBuffer_.data(), remaining);
-                    self->totalBodyBytes_ += remaining;
-                    self->requestBuffer_.clear();
-
-                    self->processRequest();
-                }
-            );
-        } else {
-            // We already have the full body
-            processRequest();
+ChunkedDecoder::Status Connection::decodeChunks(std::string_view input, std::size_t& consumed) {
+    // Every complete chunk in input is delivered before returning, so a
+    // client sending many small chunks costs one pass per read, not per chunk
+    consumed = 0;
+    for (;;) {
+        std::size_t used = 0;
+        std::string_view data;
+        const auto status = chunkDecoder_.decode(input.substr(consumed), used, data);
+        consumed += used;
+        switch (status) {
+        case ChunkedDecoder::Status::Data:
+            totalBodyBytes_ += data.size();
+            if (!deliverBody(data)) {
+                return ChunkedDecoder::Status::Invalid; // Already answered
+            }
+            break;
+        case ChunkedDecoder::Status::Invalid:
+            sendError(400);
+            return status;
+        case ChunkedDecoder::Status::TooLarge:
+            sendError(413);
+            return status;
+        default:
+            return status; // NeedMore or Done
         }
-    } catch (const std::exception&) {
-        sendError(400);
     }
 }
 
-void Connection::handleChunkedBody() {
-    // Read the next chunk size line
-    boost::asio::async_read_until(
-        socket_,
-        boost::asio::dynamic_buffer(requestBuffer_),
-        "\r\n",
-        [self = shared_from_this()](auto error, auto bytes) {
+void Connection::readChunkedBody() {
+    // The decoder keeps its place in the framing, so every read starts with
+    // an empty buffer and nothing already decoded is read again
+    armTimeout(Phase::Body);
+    chunkBuffer_.resize(kStreamBodyReadBytes);
+    socket_.async_read_some(
+        boost::asio::buffer(&chunkBuffer_[0], chunkBuffer_.size()),
+        [self = shared_from_this()](auto error, std::size_t bytes) {
+            self->chunkBuffer_.resize(bytes);
             if (error) {
                 self->handleNetworkError(error);
                 return;
             }
-            self->processChunkedBody(bytes);
+
+            std::size_t consumed = 0;
+            const auto status = self->decodeChunks(self->chunkBuffer_, consumed);
+            if (status == ChunkedDecoder::Status::NeedMore) {
+                self->readChunkedBody();
+            } else if (status == ChunkedDecoder::Status::Done) {
+                // Whatever follows is the next request; readNextRequest()
+                // moves it back into requestBuffer_
+                self->chunkBuffer_.erase(0, consumed);
+                self->processRequest();
+            }
         }
     );
 }
 
-void Connection::processChunkedBody(std::size_t bytes_transferred) {
-    // bytes_transferred includes the chunk size line + "\r\n"
-    const std::string sizeLine = requestBuffer_.substr(0, bytes_transferred);
-    std::size_t chunkSize = 0;
-    try {
-        chunkSize = std::stoul(sizeLine, nullptr, 16);
-    } catch (const std::exception&) {
-        sendError(400);
+void Connection::processRequest() {
+    // Nothing waits on the client until the response is written. The
+    // handler side holds the response until it returns; a streamed route
+    // took that hold in startStreamedRequest().
+    clearTimeout();
+    if (streamingBody_) {
+        // The handler already ran when the head arrived; it answers here
+        std::exception_ptr error;
+        try {
+            if (req_.onEnd_) {
+                req_.onEnd_();
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        release(error);
         return;
     }
 
-    // Remove the size line and trailing "\r\n"
-    requestBuffer_.erase(0, bytes_transferred);
-
-    if (chunkSize == 0) {
-        // End of chunks: no more data, process the full request
-        processRequest();
-        return;
+    hold();
+    // At this point the full body is in req_.body or the spill file, or
+    // already in the view when it arrived with the head in zero-copy mode
+    if (req_.bodyFile) {
+        req_.bodyFile->seal();
+        req_.view.body = req_.bodyFile->data();
+    } else if (req_.view.body.empty()) {
+        req_.view.body = req_.body;
     }
 
-    if (exceedsBodyLimit(totalBodyBytes_, chunkSize)) {
-        sendError(413);
+    if (route_ && route_->blocking) {
+        runChainBlocking(*route_->blocking);
         return;
     }
+    std::exception_ptr error;
+    try {
+        runChain();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    release(error);
+}
 
-    // Read the chunk data (+2 for the trailing "\r\n")
-    boost::asio::async_read(
-        socket_,
-        boost::asio::dynamic_buffer(requestBuffer_),
-        boost::asio::transfer_exactly(chunkSize + 2),
-        [self = shared_from_this(), chunkSize](auto error, auto) {
-            if (error) {
-                self->handleNetworkError(error);
-                return;
+void Connection::runChain() {
+    middlewareStack_.run(req_, res_, [this]() {
+        // Owned requests route on req_.path, which middleware may rewrite
+        if (!options_.zeroCopyRequests && req_.path != req_.view.path) {
+            route_ = handlerLookup_(lookupMethod(req_.method), req_.path, req_, routePin_);
+        }
+        if (route_) {
+            runRoute(*route_);
+        } else {
+            // Unmatched route: an ordinary response, so keep-alive survives
+            res_.sendNotFound();
+        }
+    });
+}
+
+void Connection::runChainBlocking(BlockingExecutor& pool) {
+    // The whole chain moves to the pool thread, so middleware that works on
+    // the response after next() sees what the handler did. req_ and res_
+    // belong to that thread until the task posts its release back here.
+    offloaded_ = true;
+    const bool queued = pool.submit([self = shared_from_this()]() {
+        std::exception_ptr error;
+        try {
+            self->runChain();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        boost::asio::post(self->executor(), [self, error]() {
+            self->offloaded_ = false;
+            for (auto& task : std::exchange(self->afterOffload_, {})) {
+                task();
             }
+            self->release(error);
+        });
+    });
+    if (!queued) {
+        offloaded_ = false;
+        res_.setStatus(503);
+        res_.setHeader(KnownHeader::ContentType, "text/html");
+        res_.setHeader("Retry-After", "1");
+        res_.body = "<html><body><h1>503 Service Unavailable</h1></body></html>";
+        release();
+    }
+}
 
-            // Append chunk data (exclude trailing "\r\n")
-            self->req_.body.append(self->requestBuffer_.data(), chunkSize);
-            self->requestBuffer_.erase(0, chunkSize + 2);
-            self->totalBodyBytes_ += chunkSize;
+void Connection::runRoute(const Route& route) {
+    if (!route.middleware) {
+        callHandler(route);
+        return;
+    }
+    // The route's own middleware may answer without reaching the handler
+    route.middleware->run(req_, res_, [this, &route]() {
+        callHandler(route);
+    });
+}
 
-            // Read the next chunk
-            self->handleChunkedBody();
+void Connection::callHandler(const Route& route) {
+    handlerStarted_ = true;
+    route.handler(req_, res_);
+}
+
+void Connection::completeRequest() {
+    // Every hold is released: the response is as complete as the handler
+    // side will make it
+    if (holdError_) {
+        try {
+            std::rethrow_exception(std::exchange(holdError_, nullptr));
+        } catch (const std::exception& e) {
+            std::cerr << "Processing error: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Processing error: unknown exception" << std::endl;
         }
-    );
+        if (streamStarted_) {
+            closeConnection(); // Headers are already out; the client sees a truncated body
+        } else {
+            sendError(500);
+        }
+        return;
+    }
+    if (streamStarted_) {
+        // A streamed response finishes the request once end() is written
+        if (streamEnded_ && !writeInFlight_ && streamPending_.empty()) {
+            streamStarted_ = false;
+            streamEnded_ = false;
+            finishRequest();
+        }
+        return;
+    }
+    buildResponse();
+    finishRequest();
 }
 
-void Connection::processRequest() {
-    try {
-        // At this point, req_.body already contains the full body (if any).
-        // No need to re-scan or re-parse the buffer for "\r\n\r\n".
+Connection* Connection::of(Response& res) {
+    return res.stream_ ? static_cast<Connection*>(res.stream_) : nullptr;
+}
 
-        middlewareStack_.run(req_, res_, [this]() {
-            RequestHandler handler = handlerLookup_(req_.method, req_.path, req_);
-            if (handler) {
-                handler(req_, res_);
-            } else {
-                // Send 404 for unmatched routes
-                sendError(404);
-            }
+boost::asio::any_io_executor Connection::executor() {
+    return socket_.get_executor();
+}
+
+void Connection::hold() {
+    ++holds_;
+}
+
+void Connection::release(std::exception_ptr error) {
+    if (error && !holdError_) {
+        holdError_ = error;
+    }
+    // The one transition that sends the response: the last hold going away
+    const std::size_t remaining = holds_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    // Innermost waiters first: they were registered at the highest counts
+    while (!holdWaiters_.empty() && holdWaiters_.back().first >= remaining) {
+        auto callback = std::move(holdWaiters_.back().second);
+        holdWaiters_.pop_back();
+        callback();
+    }
+    if (remaining == 0 && !isClosed_) {
+        completeRequest();
+    }
+}
+
+DeferredResponse Connection::defer() {
+    hold();
+    // The handle keeps the connection alive; completing it from any thread
+    // posts the release back to this connection's executor
+    return DeferredResponse([self = shared_from_this()](DeferredResponse::Fill fill, std::exception_ptr error) {
+        boost::asio::post(self->executor(), [self, fill = std::move(fill), error]() mutable {
+            self->completeDeferred(std::move(fill), error);
         });
+    });
+}
 
-        buildResponse();
-        sendResponse();
-    } catch (const std::exception& e) {
-        std::cerr << "Processing error: " << e.what() << std::endl;
-        sendError(500);
+void Connection::completeDeferred(DeferredResponse::Fill fill, std::exception_ptr error) {
+    if (offloaded_) {
+        // A blocking chain still owns res_; fill it in once that is done
+        afterOffload_.push_back([this, fill = std::move(fill), error]() mutable {
+            completeDeferred(std::move(fill), error);
+        });
+        return;
+    }
+    if (fill && !isClosed_) {
+        try {
+            fill(res_);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    release(error);
+}
+
+void Connection::whenReleased(std::size_t holds, std::function<void()> callback) {
+    if (holds_ <= holds || isClosed_) {
+        callback();
+        return;
+    }
+    holdWaiters_.emplace_back(holds, std::move(callback));
+}
+
+void Connection::finishRequest() {
+    if (!keepAlive_) {
+        flushResponses([this]() { closeConnection(); });
+    } else if (++batchedResponses_ >= kMaxBatchedResponses) {
+        // Bound the memory and recursion a long pipeline can build up
+        flushResponses([this]() { readNextRequest(); });
+    } else {
+        readNextRequest(); // Pipelined requests already buffered are answered in the same batch
     }
 }
 
 void Connection::buildResponse() {
-    const bool keep_alive = isKeepAliveRequested();
-    std::string statusText = HttpParser::statusText(res_.statusCode);
+    const std::string_view body = res_.bodyView();
+    const bool inlineBody = body.size() <= kInlineBodyBytes;
 
-    responseData_.clear();
-    // Reserve to minimize reallocations: status line + headers + body
+    // Appended to any responses already queued for this batch. The body is
+    // only copied in when it is small; larger ones go out as their own buffer.
     responseData_.reserve(
-        res_.body.size() +
-        statusText.size() +
-        64 +
-        res_.headers.size() * 32
+        responseData_.size() +
+        (inlineBody ? body.size() : 0) +
+        96 +
+        (res_.headers.size() + kKnownHeaderCount) * 32
     );
+    appendResponseHead(body.size(), false);
 
-    responseData_.append(req_.version);
-    responseData_.push_back(' ');
-    responseData_.append(std::to_string(res_.statusCode));
-    responseData_.push_back(' ');
-    responseData_.append(statusText);
-    responseData_.append("\r\n");
+    if (req_.view.methodId == Method::Head) {
+        return; // Same headers as GET, Content-Length included, but no body
+    }
+    if (inlineBody) {
+        responseData_.append(body);
+    } else if (res_.sharedBody) {
+        pendingBodies_.push_back({responseData_.size(), std::string(), std::move(res_.sharedBody)});
+    } else {
+        pendingBodies_.push_back({responseData_.size(), std::move(res_.body), nullptr});
+    }
+}
 
-    responseData_.append("Content-Length: ");
-    responseData_.append(std::to_string(res_.body.size()));
-    responseData_.append("\r\n");
+void Connection::appendResponseHead(std::size_t contentLength, bool streamed) {
+    res_.mergeKnownHeaders();
+    // A handler can end the connection with res.setHeader("Connection", "close")
+    keepAlive_ = !bodyUnread_ && isKeepAliveRequested() &&
+                 !iequals(res_.getHeader(KnownHeader::Connection), "close");
+    if (streamed && !streamChunked_) {
+        keepAlive_ = false; // HTTP/1.0 stream: closing the connection ends the body
+    }
+
+    // statusLine starts with "HTTP/1.1"; answer in the request's version
+    const std::string_view statusLine = HttpParser::statusLine(res_.statusCode);
+    responseData_.append(req_.view.version);
+    responseData_.append(statusLine.substr(req_.view.version.size()));
+
+    if (!streamed) {
+        char length[24];
+        const auto converted = std::to_chars(length, length + sizeof(length), contentLength);
+        responseData_.append("Content-Length: ");
+        responseData_.append(length, converted.ptr);
+        responseData_.append("\r\n");
+    } else if (streamChunked_) {
+        responseData_.append("Transfer-Encoding: chunked\r\n");
+    }
 
     responseData_.append("Connection: ");
-    responseData_.append(keep_alive ? "keep-alive" : "close");
+    responseData_.append(keepAlive_ ? "keep-alive" : "close");
     responseData_.append("\r\n");
 
+    if (!res_.hasHeader(KnownHeader::Date)) {
+        responseData_.append("Date: ");
+        responseData_.append(httpDate());
+        responseData_.append("\r\n");
+    }
+
+    // Framing headers are always written above from the actual body and
+    // keep-alive decision
+    for (std::size_t i = 0; i < kKnownHeaderCount; ++i) {
+        const auto name = static_cast<KnownHeader>(i);
+        if (!res_.hasHeader(name) || name == KnownHeader::ContentLength ||
+            name == KnownHeader::Connection || name == KnownHeader::TransferEncoding) {
+            continue;
+        }
+        responseData_.append(knownHeaderName(name));
+        responseData_.append(": ");
+        responseData_.append(res_.knownHeaders[i]);
+        responseData_.append("\r\n");
+    }
+
     for (const auto& [key, value] : res_.headers) {
         responseData_.append(key);
         responseData_.append(": ");
@@ -312,25 +755,141 @@ void Connection::buildResponse() {
     }
 
     responseData_.append("\r\n");
-    responseData_.append(res_.body);
 }
 
-void Connection::sendResponse() {
+bool Connection::write(std::string_view chunk) {
+    if (isClosed_ || streamEnded_) {
+        return false;
+    }
+    if (!streamStarted_) {
+        // Headers go out behind any pipelined responses still queued
+        streamStarted_ = true;
+        streamChunked_ = req_.view.version == "HTTP/1.1";
+        appendResponseHead(0, true);
+    }
+
+    if (!chunk.empty() && req_.view.methodId != Method::Head) {
+        if (streamChunked_) {
+            char size[16];
+            const auto converted = std::to_chars(size, size + sizeof(size), chunk.size(), 16);
+            streamPending_.append(size, converted.ptr);
+            streamPending_.append("\r\n");
+            streamPending_.append(chunk);
+            streamPending_.append("\r\n");
+        } else {
+            streamPending_.append(chunk);
+        }
+    }
+
+    pumpStream();
+    return streamPending_.size() < kStreamHighWaterBytes;
+}
+
+void Connection::end() {
+    if (!streamStarted_ || streamEnded_ || isClosed_) {
+        return;
+    }
+    streamEnded_ = true;
+    if (streamChunked_ && req_.view.methodId != Method::Head) {
+        streamPending_.append("0\r\n\r\n");
+    }
+    pumpStream();
+}
+
+void Connection::onDrain(std::function<void()> callback) {
+    if (isClosed_ || streamEnded_) {
+        return;
+    }
+    if (!streamStarted_) {
+        write({}); // Waiting to stream implies streaming: send the head now
+    }
+    drainCallback_ = std::move(callback);
+    if (!writeInFlight_ && streamPending_.empty()) {
+        // Nothing is waiting to be sent; let the write completion path call it
+        // so handlers never recurse through write()
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()]() {
+            if (!self->isClosed_ && !self->writeInFlight_) {
+                self->handleStreamWritten();
+            }
+        });
+    }
+}
+
+void Connection::pumpStream() {
+    if (writeInFlight_ || isClosed_) {
+        return;
+    }
+    // responseData_ is idle here; it may still hold the response head and
+    // earlier pipelined responses
+    if (responseData_.empty()) {
+        responseData_.swap(streamPending_);
+    } else {
+        responseData_.append(streamPending_);
+        streamPending_.clear();
+    }
+    if (responseData_.empty()) {
+        return;
+    }
+
+    writeInFlight_ = true;
+    flushResponses([this]() { handleStreamWritten(); });
+}
+
+void Connection::handleStreamWritten() {
+    writeInFlight_ = false;
+    armTimeout(Phase::Idle); // A slow but progressing stream is not idle
+
+    if (drainCallback_ && streamPending_.size() < kStreamHighWaterBytes) {
+        auto callback = std::move(drainCallback_);
+        drainCallback_ = nullptr;
+        callback(); // May write() more or end() the stream
+    }
+
+    if (writeInFlight_) {
+        return; // The callback started the next write
+    }
+    if (!streamPending_.empty()) {
+        pumpStream();
+        return;
+    }
+    if (streamEnded_ && holds_ == 0) {
+        completeRequest(); // Otherwise the last release() does
+    }
+}
+
+void Connection::flushResponses(std::function<void()> next) {
+    if (responseData_.empty()) {
+        next();
+        return;
+    }
+
+    // Every response queued since the last flush goes out in one gathered
+    // write: header blocks from responseData_ interleaved with the bodies
+    writeBuffers_.clear();
+    std::size_t from = 0;
+    for (const auto& pending : pendingBodies_) {
+        writeBuffers_.push_back(boost::asio::buffer(responseData_.data() + from, pending.headerEnd - from));
+        writeBuffers_.push_back(pending.shared ? boost::asio::buffer(*pending.shared)
+                                               : boost::asio::buffer(pending.body));
+        from = pending.headerEnd;
+    }
+    if (from < responseData_.size()) {
+        writeBuffers_.push_back(boost::asio::buffer(responseData_.data() + from, responseData_.size() - from));
+    }
+
+    armTimeout(Phase::Write);
     boost::asio::async_write(
         socket_,
-        boost::asio::buffer(responseData_),
-        [self = shared_from_this()](auto error, auto /*bytes_transferred*/) {
+        writeBuffers_,
+        [self = shared_from_this(), next = std::move(next)](auto error, auto /*bytes_transferred*/) {
             if (error) {
                 self->handleNetworkError(error);
                 return;
             }
-
-            // Handle keep-alive
-            if (self->isKeepAliveRequested()) {
-                self->start(); // Reset for next request
-            } else {
-                self->closeConnection();
-            }
+            self->responseData_.clear();
+            self->pendingBodies_.clear();
+            self->batchedResponses_ = 0;
+            next();
         }
     );
 }
@@ -351,50 +910,87 @@ void Connection::handleNetworkError(const boost::system::error_code& error) {
 }
 
 void Connection::sendError(int statusCode) {
-    if (statusCode == 404) {
-        responseData_ =
-            "HTTP/1.1 404 Not Found\r\n"
-            "Content-Type: text/html\r\n"
-            "Content-Length: 45\r\n"
-            "Connection: close\r\n\r\n"
-            "<html><body><h1>404 Not Found</h1></body></html>";
-    } else {
-        // Generate a simple error page without external files
-        std::string errorHtml = "<html><body><h1>Error " +
-                                std::to_string(statusCode) +
-                                "</h1><p>An error occurred while processing your request.</p></body></html>";
+    // Generate a simple error page without external files
+    const std::string errorHtml = "<html><body><h1>Error " +
+                                  std::to_string(statusCode) +
+                                  "</h1><p>An error occurred while processing your request.</p></body></html>";
 
-        std::ostringstream oss;
-        oss << "HTTP/1.1 " << statusCode << " " << HttpParser::statusText(statusCode) << "\r\n";
-        oss << "Content-Type: text/html\r\n";
-        oss << "Content-Length: " << errorHtml.size() << "\r\n";
-        oss << "Connection: close\r\n\r\n";
-        oss << errorHtml;
+    // Queued behind any pipelined responses that are still unsent
+    keepAlive_ = false;
+    responseData_.append(HttpParser::statusLine(statusCode));
+    responseData_.append("Content-Type: text/html\r\n");
+    responseData_.append("Content-Length: ");
+    responseData_.append(std::to_string(errorHtml.size()));
+    responseData_.append("\r\nConnection: close\r\nDate: ");
+    responseData_.append(httpDate());
+    responseData_.append("\r\n\r\n");
+    if (req_.view.methodId != Method::Head) {
+        responseData_.append(errorHtml);
+    }
+    flushResponses([this]() { closeConnection(); });
+}
 
-        responseData_ = oss.str();
+void Connection::armTimeout(Phase phase) {
+    if (phase == Phase::Header && timeoutPhase_ == Phase::Header && timeoutScheduled()) {
+        return; // A head has one deadline however it trickles in (slowloris)
+    }
+    timeoutPhase_ = phase;
+    const ConnectionTimeouts& timeouts = options_.timeouts;
+    std::chrono::milliseconds delay = timeouts.idle;
+    switch (phase) {
+    case Phase::Idle:   delay = timeouts.idle; break;
+    case Phase::Header: delay = timeouts.header; break;
+    case Phase::Body:   delay = timeouts.body; break;
+    case Phase::Write:  delay = timeouts.write; break;
+    }
+    if (timers_) {
+        timers_->schedule(timeout_, delay);
+        return;
     }
 
-    boost::asio::async_write(
-        socket_,
-        boost::asio::buffer(responseData_),
-        [self = shared_from_this()](auto, auto) {
+    timeoutArmed_ = true;
+    timeoutTimer_.expires_after(delay);
+    timeoutTimer_.async_wait([weak = weak_from_this()](const boost::system::error_code& error) {
+        auto self = weak.lock();
+        // A wait that completed just before the deadline moved finds it
+        // in the future
+        if (!error && self && self->timeoutArmed_ &&
+            self->timeoutTimer_.expiry() <= std::chrono::steady_clock::now()) {
             self->closeConnection();
         }
-    );
+    });
 }
 
-void Connection::resetTimeout() {
-    timeoutTimer_.expires_after(std::chrono::seconds(30)); // 30-second timeout
-    timeoutTimer_.async_wait([self = shared_from_this()](auto error) {
-        if (!error) {
-            self->closeConnection();
-        }
-    });
+void Connection::clearTimeout() {
+    if (timers_) {
+        timers_->cancel(timeout_);
+    } else if (timeoutArmed_) {
+        timeoutArmed_ = false;
+        timeoutTimer_.cancel();
+    }
+}
+
+bool Connection::timeoutScheduled() const {
+    return timers_ ? timeout_.scheduled() : timeoutArmed_;
 }
 
 void Connection::closeConnection() {
     if (isClosed_) return; // Ensure socket is only closed once
     isClosed_ = true;
+    clearTimeout();
+
+    // Let coroutines waiting on the rest of the chain finish
+    for (auto& waiter : std::exchange(holdWaiters_, {})) {
+        waiter.second();
+    }
+
+    // Release a spilled body now rather than whenever the last handler
+    // callback lets go of this connection, unless a blocking chain is
+    // still reading it
+    if (!offloaded_) {
+        req_.view.body = {};
+        req_.bodyFile.reset();
+    }
 
     boost::system::error_code ec;
 
@@ -418,10 +1014,11 @@ bool Connection::isKeepAliveRequested() const {
 }
 
 bool Connection::wantsKeepAlive(const Request& req) {
-    bool keepAlive = req.version == "HTTP/1.1";
-    auto it = req.headers.find("connection");
-    if (it != req.headers.end()) {
-        const std::string& value = it->second;
+    const std::string_view version = req.view.version.empty() ? std::string_view(req.version)
+                                                              : req.view.version;
+    bool keepAlive = version == "HTTP/1.1";
+    if (req.hasHeader(KnownHeader::Connection)) {
+        const std::string_view value = req.header(KnownHeader::Connection);
         if (iequals(value, "close")) {
             keepAlive = false;
         } else if (iequals(value, "keep-alive")) {
@@ -431,13 +1028,45 @@ bool Connection::wantsKeepAlive(const Request& req) {
     return keepAlive;
 }
 
-bool Connection::exceedsBodyLimit(std::size_t currentBytes, std::size_t incomingBytes) {
-    return incomingBytes > kMaxBodySizeBytes ||
-           currentBytes > kMaxBodySizeBytes ||
-           (incomingBytes > 0 && currentBytes > kMaxBodySizeBytes - incomingBytes);
+bool Connection::exceedsBodyLimit(std::size_t currentBytes, std::size_t incomingBytes, std::size_t limit) {
+    return incomingBytes > limit ||
+           currentBytes > limit ||
+           (incomingBytes > 0 && currentBytes > limit - incomingBytes);
+}
+
+int Connection::transferEncodingStatus(std::string_view value) {
+    // Codings are listed in the order they were applied, so chunked has to
+    // be the last one and appear only once (RFC 9112 section 6)
+    bool sawChunked = false;
+    bool sawOther = false;
+    bool lastChunked = false;
+    while (!value.empty()) {
+        const std::size_t comma = value.find(',');
+        std::string_view coding = value.substr(0, comma);
+        value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+        while (!coding.empty() && (coding.front() == ' ' || coding.front() == '\t')) {
+            coding.remove_prefix(1);
+        }
+        while (!coding.empty() && (coding.back() == ' ' || coding.back() == '\t')) {
+            coding.remove_suffix(1);
+        }
+        if (coding.empty()) {
+            continue; // Empty list elements are allowed and ignored
+        }
+        lastChunked = iequals(coding, "chunked");
+        if (lastChunked && sawChunked) {
+            return 400;
+        }
+        sawChunked = sawChunked || lastChunked;
+        sawOther = sawOther || !lastChunked;
+    }
+    if (!lastChunked) {
+        return 400; // The body's end cannot be found
+    }
+    return sawOther ? 501 : 0;
 }
 
-bool Connection::iequals(const std::string& a, const std::string& b) {
+bool Connection::iequals(std::string_view a, std::string_view b) {
     return std::equal(a.begin(), a.end(),
                       b.begin(), b.end(),
                       [](char lhs, char rhs) {
@@ -0,0 +1,90 @@
+// File: Aether/Http/Headers.cpp
+#include "Aether/Http/Headers.h"
+#include <array>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+struct HeaderNames {
+    std::string_view canonical;
+    std::string_view key;
+};
+
+// Indexed by KnownHeader
+constexpr std::array<HeaderNames, kKnownHeaderCount> kHeaderNames = {{
+    {"Accept", "accept"},
+    {"Accept-Encoding", "accept-encoding"},
+    {"Accept-Language", "accept-language"},
+    {"Authorization", "authorization"},
+    {"Cache-Control", "cache-control"},
+    {"Connection", "connection"},
+    {"Content-Disposition", "content-disposition"},
+    {"Content-Encoding", "content-encoding"},
+    {"Content-Length", "content-length"},
+    {"Content-Type", "content-type"},
+    {"Cookie", "cookie"},
+    {"Date", "date"},
+    {"ETag", "etag"},
+    {"Expect", "expect"},
+    {"Host", "host"},
+    {"If-Modified-Since", "if-modified-since"},
+    {"If-None-Match", "if-none-match"},
+    {"Last-Modified", "last-modified"},
+    {"Location", "location"},
+    {"Origin", "origin"},
+    {"Range", "range"},
+    {"Referer", "referer"},
+    {"Server", "server"},
+    {"Transfer-Encoding", "transfer-encoding"},
+    {"Upgrade", "upgrade"},
+    {"User-Agent", "user-agent"},
+    {"Vary", "vary"},
+}};
+
+// Header names bucketed by length, so a lookup compares against at most a
+// handful of candidates
+constexpr std::size_t kMaxKnownLength = 19; // "Content-Disposition"
+
+struct LengthBuckets {
+    std::array<std::array<KnownHeader, 6>, kMaxKnownLength + 1> headers{};
+    std::array<unsigned char, kMaxKnownLength + 1> counts{};
+};
+
+constexpr LengthBuckets makeLengthBuckets() {
+    LengthBuckets buckets{};
+    for (std::size_t i = 0; i < kKnownHeaderCount; ++i) {
+        const std::size_t length = kHeaderNames[i].key.size();
+        buckets.headers[length][buckets.counts[length]++] = static_cast<KnownHeader>(i);
+    }
+    return buckets;
+}
+
+constexpr LengthBuckets kLengthBuckets = makeLengthBuckets();
+
+} // anonymous namespace
+
+std::string_view knownHeaderName(KnownHeader header) {
+    return kHeaderNames[headerIndex(header)].canonical;
+}
+
+std::string_view knownHeaderKey(KnownHeader header) {
+    return kHeaderNames[headerIndex(header)].key;
+}
+
+KnownHeader lookupKnownHeader(std::string_view name) {
+    if (name.size() > kMaxKnownLength) {
+        return KnownHeader::Count;
+    }
+    const auto& candidates = kLengthBuckets.headers[name.size()];
+    for (std::size_t i = 0; i < kLengthBuckets.counts[name.size()]; ++i) {
+        if (equalsIgnoreCase(name, kHeaderNames[headerIndex(candidates[i])].key)) {
+            return candidates[i];
+        }
+    }
+    return KnownHeader::Count;
+}
+
+} // namespace Http
+} // namespace Aether
@@ -0,0 +1,77 @@
+// File: Aether/Http/HttpDate.cpp
+#include "Aether/Http/HttpDate.h"
+#include <time.h>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+constexpr std::size_t kHttpDateLength = 29;
+
+// Seconds since the epoch from the cheapest clock available; a coarse clock
+// is plenty since the header only has second resolution
+inline std::time_t coarseNow() {
+#ifdef CLOCK_REALTIME_COARSE
+    timespec ts;
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+        return ts.tv_sec;
+    }
+#endif
+    return std::time(nullptr);
+}
+
+inline void putTwoDigits(char* out, int value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+struct DateCache {
+    std::time_t second = -1;
+    char value[kHttpDateLength];
+};
+
+} // anonymous namespace
+
+void formatHttpDate(std::time_t t, char* out) {
+    // Fixed English names: strftime would follow the global locale
+    static constexpr char days[] = "SunMonTueWedThuFriSat";
+    static constexpr char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+
+    const char* day = days + tm.tm_wday * 3;
+    const char* month = months + tm.tm_mon * 3;
+    const int year = tm.tm_year + 1900;
+
+    out[0] = day[0]; out[1] = day[1]; out[2] = day[2];
+    out[3] = ','; out[4] = ' ';
+    putTwoDigits(out + 5, tm.tm_mday);
+    out[7] = ' ';
+    out[8] = month[0]; out[9] = month[1]; out[10] = month[2];
+    out[11] = ' ';
+    putTwoDigits(out + 12, year / 100);
+    putTwoDigits(out + 14, year % 100);
+    out[16] = ' ';
+    putTwoDigits(out + 17, tm.tm_hour);
+    out[19] = ':';
+    putTwoDigits(out + 20, tm.tm_min);
+    out[22] = ':';
+    putTwoDigits(out + 23, tm.tm_sec);
+    out[25] = ' '; out[26] = 'G'; out[27] = 'M'; out[28] = 'T';
+}
+
+std::string_view httpDate() {
+    thread_local DateCache cache;
+
+    const std::time_t now = coarseNow();
+    if (now != cache.second) {
+        formatHttpDate(now, cache.value);
+        cache.second = now;
+    }
+    return std::string_view(cache.value, kHttpDateLength);
+}
+
+} // namespace Http
+} // namespace Aether
@@ -1,189 +1,572 @@
 #include "Aether/Http/HttpParser.h"
 
 #include <algorithm>
-#include <cctype>
-#include <vector>
+#include <array>
+#include <cstring>
+
+// SIMD scanners are compiled with per-function target attributes and picked
+// at runtime, so the binary still runs on CPUs without SSE4.2/AVX2. Define
+// AETHER_HTTP_NO_SIMD to build the scalar scanner only.
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(AETHER_HTTP_NO_SIMD)
+#define AETHER_HTTP_X86_SIMD 1
+#include <immintrin.h>
+#endif
 
 namespace Aether {
 namespace Http {
 
 namespace {
 
-// Trim leading/trailing whitespace (space, tab, CR, LF) from a string_view
-inline std::string_view trim(std::string_view sv) {
-    // leading
-    while (!sv.empty() && (sv.front() == ' ' || sv.front() == '\t' ||
-                           sv.front() == '\r' || sv.front() == '\n')) {
-        sv.remove_prefix(1);
+// Character classes used by the scanners, one bit per class
+enum : unsigned char {
+    kTokenChar  = 1, // RFC 7230 tchar: methods and header names
+    kTargetChar = 2, // Anything but CTL and SP: request-target
+    kValueChar  = 4  // VCHAR, obs-text, SP and HTAB: header values
+};
+
+constexpr std::array<unsigned char, 256> makeCharClasses() {
+    std::array<unsigned char, 256> classes{};
+    for (int c = 0; c < 256; ++c) {
+        const bool alnum = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool token = alnum;
+        for (char t : {'!', '#', '$', '%', '&', '\'', '*', '+', '-', '.', '^', '_', '`', '|', '~'}) {
+            token = token || c == static_cast<unsigned char>(t);
+        }
+        unsigned char cls = 0;
+        if (token) cls |= kTokenChar;
+        if (c > 0x20 && c != 0x7f) cls |= kTargetChar;
+        if ((c >= 0x20 && c != 0x7f) || c == '\t') cls |= kValueChar;
+        classes[c] = cls;
     }
-    // trailing
-    while (!sv.empty() && (sv.back() == ' ' || sv.back() == '\t' ||
-                           sv.back() == '\r' || sv.back() == '\n')) {
-        sv.remove_suffix(1);
+    return classes;
+}
+
+constexpr std::array<unsigned char, 256> kCharClass = makeCharClasses();
+
+// A scanner returns the first byte in [p, end) outside its character class,
+// or end if every byte belongs to it. The head-end finders use the same
+// signature but return the position just past the first "\r\n\r\n", or
+// nullptr if there is none.
+using ScanFn = const char* (*)(const char* p, const char* end);
+
+inline const char* scanScalar(const char* p, const char* end, unsigned char cls) {
+    while (p < end && (kCharClass[static_cast<unsigned char>(*p)] & cls)) {
+        ++p;
     }
-    return sv;
+    return p;
 }
 
-} // anonymous namespace
+const char* scanTokenScalar(const char* p, const char* end) {
+    return scanScalar(p, end, kTokenChar);
+}
 
-// Map status codes to reason phrases
-std::string HttpParser::statusText(int statusCode) {
-    static const std::unordered_map<int, std::string> texts = {
-        {200, "OK"},
-        {201, "Created"},
-        {204, "No Content"},
-        {400, "Bad Request"},
-        {401, "Unauthorized"},
-        {403, "Forbidden"},
-        {404, "Not Found"},
-        {413, "Payload Too Large"},
-        {431, "Request Header Fields Too Large"},
-        {500, "Internal Server Error"}
+const char* scanTargetScalar(const char* p, const char* end) {
+    return scanScalar(p, end, kTargetChar);
+}
+
+const char* scanValueScalar(const char* p, const char* end) {
+    return scanScalar(p, end, kValueChar);
+}
+
+const char* findHeadEndScalar(const char* p, const char* end) {
+    while (end - p >= 4) {
+        p = static_cast<const char*>(std::memchr(p, '\r', static_cast<std::size_t>(end - p - 3)));
+        if (!p) {
+            return nullptr;
+        }
+        if (std::memcmp(p, "\r\n\r\n", 4) == 0) {
+            return p + 4;
+        }
+        ++p;
+    }
+    return nullptr;
+}
+
+#ifdef AETHER_HTTP_X86_SIMD
+
+// SSE4.2: PCMPESTRI finds the first byte inside any of up to eight ranges.
+// "|" and "~" are tchars but sit inside the last range to keep it at eight,
+// so a hit is confirmed against the table before stopping.
+__attribute__((target("sse4.2")))
+const char* scanTokenSse42(const char* p, const char* end) {
+    alignas(16) static const char ranges[16] = {
+        '\x00', ' ', '"', '"', '(', ')', ',', ',',
+        '/', '/', ':', '@', '[', ']', '{', '\xff'
     };
+    const __m128i rangeVec = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+
+    while (end - p >= 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int idx = _mm_cmpestri(rangeVec, 16, bytes, 16,
+                                     _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+        if (idx == 16) {
+            p += 16;
+            continue;
+        }
+        p += idx;
+        if (!(kCharClass[static_cast<unsigned char>(*p)] & kTokenChar)) {
+            return p;
+        }
+        ++p;
+    }
+    return scanTokenScalar(p, end);
+}
 
-    auto it = texts.find(statusCode);
-    return (it != texts.end()) ? it->second : "Unknown";
+// SSE2 (always present on x86-64): 16 bytes per step using unsigned
+// min-compare tricks for "byte <= limit".
+inline __m128i lessOrEqual(__m128i bytes, char limit) {
+    return _mm_cmpeq_epi8(_mm_min_epu8(bytes, _mm_set1_epi8(limit)), bytes);
 }
 
-// Legacy overload: keep compatibility, forward to string_view version
-bool HttpParser::parseRequest(const std::string& rawRequest, Request& req) {
-    return parseRequest(std::string_view(rawRequest.data(), rawRequest.size()), req);
+const char* scanTargetSse2(const char* p, const char* end) {
+    while (end - p >= 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i bad = _mm_or_si128(lessOrEqual(bytes, 0x20),
+                                         _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x7f)));
+        const int mask = _mm_movemask_epi8(bad);
+        if (mask) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+    return scanTargetScalar(p, end);
 }
 
-bool HttpParser::parseRequest(std::string_view rawRequest, Request& req) {
-    // Locate end of headers: "\r\n\r\n"
-    const std::string_view delimiter = "\r\n\r\n";
-    std::size_t headerEnd = rawRequest.find(delimiter);
-    if (headerEnd == std::string_view::npos) {
-        return false; // incomplete request
+const char* scanValueSse2(const char* p, const char* end) {
+    while (end - p >= 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i ctl = _mm_andnot_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')),
+                                             lessOrEqual(bytes, 0x1f));
+        const __m128i bad = _mm_or_si128(ctl, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x7f)));
+        const int mask = _mm_movemask_epi8(bad);
+        if (mask) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
     }
+    return scanValueScalar(p, end);
+}
+
+// Compares four overlapping loads against "\r", "\n", "\r", "\n", so a bit
+// is set where a terminator starts; the last load must stay inside the buffer
+const char* findHeadEndSse2(const char* p, const char* end) {
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    while (end - p >= 16 + 3) {
+        const __m128i first = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), cr),
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), lf));
+        const __m128i second = _mm_and_si128(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2)), cr),
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 3)), lf));
+        const int mask = _mm_movemask_epi8(_mm_and_si128(first, second));
+        if (mask) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask)) + 4;
+        }
+        p += 16;
+    }
+    return findHeadEndScalar(p, end);
+}
 
-    // Split header block and body
-    std::string_view headerBlock = rawRequest.substr(0, headerEnd);
-    std::string_view bodyBlock = rawRequest.substr(headerEnd + delimiter.size());
+// AVX2: same checks as SSE2, 32 bytes per step
+__attribute__((target("avx2")))
+inline __m256i lessOrEqual256(__m256i bytes, char limit) {
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, _mm256_set1_epi8(limit)), bytes);
+}
 
-    // First line: request line up to first "\r\n"
-    std::size_t lineEnd = headerBlock.find("\r\n");
-    if (lineEnd == std::string_view::npos) {
-        return false;
+__attribute__((target("avx2")))
+const char* scanTargetAvx2(const char* p, const char* end) {
+    while (end - p >= 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i bad = _mm256_or_si256(lessOrEqual256(bytes, 0x20),
+                                            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x7f)));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(bad));
+        if (mask) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
     }
+    return scanTargetSse2(p, end);
+}
 
-    std::string_view startLine = headerBlock.substr(0, lineEnd);
-    std::string_view headerLines;
-    if (lineEnd + 2 <= headerBlock.size()) {
-        headerLines = headerBlock.substr(lineEnd + 2);
+__attribute__((target("avx2")))
+const char* scanValueAvx2(const char* p, const char* end) {
+    while (end - p >= 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i ctl = _mm256_andnot_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t')),
+                                                lessOrEqual256(bytes, 0x1f));
+        const __m256i bad = _mm256_or_si256(ctl, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x7f)));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(bad));
+        if (mask) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
     }
+    return scanValueSse2(p, end);
+}
 
-    // Parse request line (method, path, version)
-    if (!parseStartLine(startLine, req)) {
-        return false;
+__attribute__((target("avx2")))
+const char* findHeadEndAvx2(const char* p, const char* end) {
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    while (end - p >= 32 + 3) {
+        const __m256i first = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), cr),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)), lf));
+        const __m256i second = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 2)), cr),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 3)), lf));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(first, second)));
+        if (mask) {
+            return p + __builtin_ctz(mask) + 4;
+        }
+        p += 32;
+    }
+    return findHeadEndSse2(p, end);
+}
+
+#endif // AETHER_HTTP_X86_SIMD
+
+struct Scanner {
+    const char* name;
+    ScanFn token;
+    ScanFn target;
+    ScanFn value;
+    ScanFn headEnd;
+};
+
+Scanner selectScanner() {
+#ifdef AETHER_HTTP_X86_SIMD
+    __builtin_cpu_init();
+    const bool sse42 = __builtin_cpu_supports("sse4.2");
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", sse42 ? scanTokenSse42 : scanTokenScalar, scanTargetAvx2, scanValueAvx2,
+                findHeadEndAvx2};
+    }
+    if (sse42) {
+        return {"sse4.2", scanTokenSse42, scanTargetSse2, scanValueSse2, findHeadEndSse2};
+    }
+#endif
+    return {"scalar", scanTokenScalar, scanTargetScalar, scanValueScalar, findHeadEndScalar};
+}
+
+const Scanner& scanner() {
+    static const Scanner selected = selectScanner();
+    return selected;
+}
+
+// Header names are stored lowercased so lookups can use the plain map
+void assignLowercase(std::string& out, const char* src, std::size_t n) {
+    out.resize(n);
+    char* dst = &out[0];
+    std::size_t i = 0;
+#ifdef AETHER_HTTP_X86_SIMD
+    const __m128i beforeA = _mm_set1_epi8('A' - 1);
+    const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(bytes, beforeA),
+                                            _mm_cmplt_epi8(bytes, afterZ));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_or_si128(bytes, _mm_and_si128(upper, caseBit)));
+    }
+#endif
+    for (; i < n; ++i) {
+        const char c = src[i];
+        dst[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
     }
+}
+
+inline const char* fail(HttpParser::ParseResult& result, HttpParser::ParseResult why) {
+    result = why;
+    return nullptr;
+}
+
+} // anonymous namespace
+
+namespace {
 
-    // Validate HTTP method (same as your original set)
-    static const std::vector<std::string> validMethods = {"GET", "POST", "PUT", "DELETE"};
-    bool methodOk = false;
-    for (const auto& m : validMethods) {
-        if (req.method == m) {
-            methodOk = true;
-            break;
+struct StatusReason {
+    int code;
+    std::string_view reason;
+};
+
+// IANA HTTP status code registry
+constexpr StatusReason kStatusReasons[] = {
+    {100, "Continue"}, {101, "Switching Protocols"}, {102, "Processing"}, {103, "Early Hints"},
+    {200, "OK"}, {201, "Created"}, {202, "Accepted"}, {203, "Non-Authoritative Information"},
+    {204, "No Content"}, {205, "Reset Content"}, {206, "Partial Content"}, {207, "Multi-Status"},
+    {208, "Already Reported"}, {226, "IM Used"},
+    {300, "Multiple Choices"}, {301, "Moved Permanently"}, {302, "Found"}, {303, "See Other"},
+    {304, "Not Modified"}, {305, "Use Proxy"}, {307, "Temporary Redirect"}, {308, "Permanent Redirect"},
+    {400, "Bad Request"}, {401, "Unauthorized"}, {402, "Payment Required"}, {403, "Forbidden"},
+    {404, "Not Found"}, {405, "Method Not Allowed"}, {406, "Not Acceptable"},
+    {407, "Proxy Authentication Required"}, {408, "Request Timeout"}, {409, "Conflict"},
+    {410, "Gone"}, {411, "Length Required"}, {412, "Precondition Failed"},
+    {413, "Payload Too Large"}, {414, "URI Too Long"}, {415, "Unsupported Media Type"},
+    {416, "Range Not Satisfiable"}, {417, "Expectation Failed"}, {421, "Misdirected Request"},
+    {422, "Unprocessable Entity"}, {423, "Locked"}, {424, "Failed Dependency"}, {425, "Too Early"},
+    {426, "Upgrade Required"}, {428, "Precondition Required"}, {429, "Too Many Requests"},
+    {431, "Request Header Fields Too Large"}, {451, "Unavailable For Legal Reasons"},
+    {500, "Internal Server Error"}, {501, "Not Implemented"}, {502, "Bad Gateway"},
+    {503, "Service Unavailable"}, {504, "Gateway Timeout"}, {505, "HTTP Version Not Supported"},
+    {506, "Variant Also Negotiates"}, {507, "Insufficient Storage"}, {508, "Loop Detected"},
+    {510, "Not Extended"}, {511, "Network Authentication Required"},
+};
+
+constexpr std::string_view reasonFor(int statusCode) {
+    for (const auto& entry : kStatusReasons) {
+        if (entry.code == statusCode) {
+            return entry.reason;
         }
     }
-    if (!methodOk) {
-        return false;
+    return "Unknown";
+}
+
+// Every "HTTP/1.1 NNN Reason\r\n" line for 100-599, laid out back to back at
+// compile time
+constexpr int kFirstStatus = 100;
+constexpr int kStatusCount = 500;
+constexpr std::string_view kStatusVersion = "HTTP/1.1 ";
+
+constexpr std::size_t statusLinesLength() {
+    std::size_t total = 0;
+    for (int code = kFirstStatus; code < kFirstStatus + kStatusCount; ++code) {
+        total += kStatusVersion.size() + 4 + reasonFor(code).size() + 2; // "NNN " ... "\r\n"
     }
+    return total;
+}
 
-    // Validate HTTP version
-    if (req.version != "HTTP/1.0" && req.version != "HTTP/1.1") {
-        return false;
+struct StatusLines {
+    char text[statusLinesLength()];
+    std::size_t offsets[kStatusCount + 1];
+};
+
+constexpr StatusLines makeStatusLines() {
+    StatusLines lines{};
+    std::size_t pos = 0;
+    for (int i = 0; i < kStatusCount; ++i) {
+        const int code = kFirstStatus + i;
+        lines.offsets[i] = pos;
+        for (char c : kStatusVersion) {
+            lines.text[pos++] = c;
+        }
+        lines.text[pos++] = static_cast<char>('0' + code / 100);
+        lines.text[pos++] = static_cast<char>('0' + code / 10 % 10);
+        lines.text[pos++] = static_cast<char>('0' + code % 10);
+        lines.text[pos++] = ' ';
+        for (char c : reasonFor(code)) {
+            lines.text[pos++] = c;
+        }
+        lines.text[pos++] = '\r';
+        lines.text[pos++] = '\n';
+    }
+    lines.offsets[kStatusCount] = pos;
+    return lines;
+}
+
+constexpr StatusLines kStatusLines = makeStatusLines();
+
+} // anonymous namespace
+
+// Map status codes to reason phrases
+std::string HttpParser::statusText(int statusCode) {
+    return std::string(reasonFor(statusCode));
+}
+
+std::string_view HttpParser::statusLine(int statusCode) {
+    if (statusCode < kFirstStatus || statusCode >= kFirstStatus + kStatusCount) {
+        statusCode = 500;
     }
+    const int i = statusCode - kFirstStatus;
+    return std::string_view(kStatusLines.text + kStatusLines.offsets[i],
+                            kStatusLines.offsets[i + 1] - kStatusLines.offsets[i]);
+}
 
-    // Parse headers into req.headers
-    if (!parseHeaders(headerLines, req)) {
+// Legacy overload: keep compatibility, forward to string_view version
+bool HttpParser::parseRequest(const std::string& rawRequest, Request& req) {
+    return parseRequest(std::string_view(rawRequest.data(), rawRequest.size()), req);
+}
+
+bool HttpParser::parseRequest(std::string_view rawRequest, Request& req) {
+    std::size_t headLength = 0;
+    if (parseRequestHead(rawRequest, req, headLength) != ParseResult::Complete) {
         return false;
     }
 
     // Parse body into req.body
-    parseBody(bodyBlock, req);
+    parseBody(rawRequest.substr(headLength), req);
+    req.view.body = req.body;
     return true;
 }
 
-bool HttpParser::parseStartLine(std::string_view line, Request& req) {
-    // Expected: "<METHOD> <PATH> <VERSION>\r\n"
-    line = trim(line);
-    if (line.empty()) return false;
+HttpParser::ParseResult HttpParser::parseRequestHead(std::string_view buffer, Request& req,
+                                                     std::size_t& headLength, std::size_t searchedLength) {
+    const ParseResult result = parseRequestHead(buffer, req.view, headLength, searchedLength);
+    if (result == ParseResult::Complete && !copyHead(req.view, req)) {
+        return ParseResult::Invalid;
+    }
+    return result;
+}
+
+HttpParser::ParseResult HttpParser::parseRequestHead(std::string_view buffer, RequestView& view,
+                                                     std::size_t& headLength, std::size_t searchedLength) {
+    if (searchedLength > 0) {
+        // Only the new bytes (plus three for a terminator split across reads)
+        // can end the head. Until one does, nothing is tokenized; once it
+        // does, the head is parsed from the start.
+        const std::size_t from = std::min(searchedLength > 3 ? searchedLength - 3 : 0, buffer.size());
+        if (!scanner().headEnd(buffer.data() + from, buffer.data() + buffer.size())) {
+            return ParseResult::Incomplete;
+        }
+    }
 
-    // Find first space (end of method)
-    std::size_t sp1 = line.find(' ');
-    if (sp1 == std::string_view::npos) return false;
+    const char* begin = buffer.data();
+    const char* end = begin + buffer.size();
+    ParseResult result = ParseResult::Complete;
+
+    const char* p = parseStartLine(begin, end, view, result);
+    if (!p) {
+        return result;
+    }
 
-    // Find second space (end of path)
-    std::size_t sp2 = line.find(' ', sp1 + 1);
-    if (sp2 == std::string_view::npos) return false;
+    p = parseHeaders(p, end, view, result);
+    if (!p) {
+        return result;
+    }
 
-    std::string_view method = line.substr(0, sp1);
-    std::string_view path   = line.substr(sp1 + 1, sp2 - (sp1 + 1));
-    std::string_view ver    = line.substr(sp2 + 1);
+    headLength = static_cast<std::size_t>(p - begin);
+    return ParseResult::Complete;
+}
 
-    method = trim(method);
-    path   = trim(path);
-    ver    = trim(ver);
+const char* HttpParser::scannerName() {
+    return scanner().name;
+}
 
-    // Store as std::string in Request
-    req.method.assign(method.begin(), method.end());
-    req.path.assign(path.begin(), path.end());
-    req.version.assign(ver.begin(), ver.end());
+const char* HttpParser::parseStartLine(const char* p, const char* end, RequestView& view, ParseResult& result) {
+    // Expected: "<METHOD> <TARGET> HTTP/1.<d>\r\n"
+    const Scanner& scan = scanner();
 
-    return true;
+    // Ignore empty lines ahead of the request line (RFC 7230 section 3.5)
+    while (end - p >= 2 && p[0] == '\r' && p[1] == '\n') {
+        p += 2;
+    }
+
+    const char* methodEnd = scan.token(p, end);
+    if (methodEnd == end) return fail(result, ParseResult::Incomplete);
+    if (methodEnd == p || *methodEnd != ' ') return fail(result, ParseResult::Invalid);
+
+    const std::string_view method(p, static_cast<std::size_t>(methodEnd - p));
+    const Method methodId = lookupMethod(method);
+    if (methodId == Method::Count) return fail(result, ParseResult::Invalid);
+
+    p = methodEnd + 1;
+    const char* targetEnd = scan.target(p, end);
+    if (targetEnd == end) return fail(result, ParseResult::Incomplete);
+    if (targetEnd == p || *targetEnd != ' ') return fail(result, ParseResult::Invalid);
+
+    const char* version = targetEnd + 1;
+    static constexpr std::size_t kVersionLineSize = sizeof("HTTP/1.1\r\n") - 1;
+    if (static_cast<std::size_t>(end - version) < kVersionLineSize) {
+        return fail(result, ParseResult::Incomplete);
+    }
+    if (std::memcmp(version, "HTTP/1.", 7) != 0 ||
+        (version[7] != '0' && version[7] != '1') ||
+        version[8] != '\r' || version[9] != '\n') {
+        return fail(result, ParseResult::Invalid);
+    }
+
+    view.method = method;
+    view.methodId = methodId;
+    view.target = std::string_view(p, static_cast<std::size_t>(targetEnd - p));
+    const std::size_t queryStart = view.target.find('?');
+    view.path = view.target.substr(0, queryStart);
+    view.query = queryStart == std::string_view::npos ? std::string_view()
+                                                      : view.target.substr(queryStart + 1);
+    view.version = std::string_view(version, 8);
+
+    return version + kVersionLineSize;
 }
 
-bool HttpParser::parseHeaders(std::string_view headerBlock, Request& req) {
-    req.headers.clear();
+const char* HttpParser::parseHeaders(const char* p, const char* end, RequestView& view, ParseResult& result) {
+    const Scanner& scan = scanner();
+    view.known.fill({});
+    view.headers.clear();
 
-    std::size_t pos = 0;
-    const std::size_t len = headerBlock.size();
+    for (;;) {
+        if (end - p < 2) return fail(result, ParseResult::Incomplete);
 
-    while (pos < len) {
-        // Find end of line
-        std::size_t lineEnd = headerBlock.find("\r\n", pos);
-        if (lineEnd == std::string_view::npos) {
-            lineEnd = len;
+        // Empty line: end of headers
+        if (p[0] == '\r') {
+            if (p[1] != '\n') return fail(result, ParseResult::Invalid);
+            return p + 2;
         }
 
-        std::string_view line = headerBlock.substr(pos, lineEnd - pos);
-        line = trim(line);
+        // field-name ":" OWS field-value OWS CRLF; obs-fold is rejected
+        const char* nameEnd = scan.token(p, end);
+        if (nameEnd == end) return fail(result, ParseResult::Incomplete);
+        if (nameEnd == p || *nameEnd != ':') return fail(result, ParseResult::Invalid);
 
-        // Empty line: end of headers
-        if (line.empty()) {
-            break;
+        const char* value = nameEnd + 1;
+        while (value < end && (*value == ' ' || *value == '\t')) {
+            ++value;
         }
 
-        // Find colon separating key and value
-        std::size_t colon = line.find(':');
-        if (colon != std::string_view::npos) {
-            std::string_view keyView = line.substr(0, colon);
-            std::string_view valueView = line.substr(colon + 1);
+        const char* valueEnd = scan.value(value, end);
+        if (valueEnd == end || valueEnd + 1 == end) return fail(result, ParseResult::Incomplete);
+        if (valueEnd[0] != '\r' || valueEnd[1] != '\n') return fail(result, ParseResult::Invalid);
 
-            keyView = trim(keyView);
-            valueView = trim(valueView);
+        const char* next = valueEnd + 2;
+        while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t')) {
+            --valueEnd;
+        }
 
-            // Normalize header key to lowercase for lookups (as you had)
-            std::string key;
-            key.reserve(keyView.size());
-            for (char c : keyView) {
-                key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        const std::string_view name(p, static_cast<std::size_t>(nameEnd - p));
+        const std::string_view fieldValue(value, static_cast<std::size_t>(valueEnd - value));
+
+        const KnownHeader slot = lookupKnownHeader(name);
+        if (slot == KnownHeader::Count) {
+            view.headers.emplace_back(name, fieldValue);
+        } else {
+            std::string_view& known = view.known[headerIndex(slot)];
+            // Repeated Host, Content-Length or Transfer-Encoding headers are a
+            // smuggling vector (RFC 7230 sections 3.3 and 5.4); other repeats
+            // keep the last value
+            if (known.data() && (slot == KnownHeader::Host || slot == KnownHeader::ContentLength ||
+                                 slot == KnownHeader::TransferEncoding)) {
+                return fail(result, ParseResult::Invalid);
             }
-
-            std::string value(valueView.begin(), valueView.end());
-            req.headers[std::move(key)] = std::move(value);
+            known = fieldValue;
         }
+        p = next;
+    }
+}
 
-        // Advance to next line
-        if (lineEnd + 2 > len) {
-            break;
+bool HttpParser::copyHead(const RequestView& view, Request& req) {
+    req.method.assign(view.method.data(), view.method.size());
+    if (view.path.find('%') == std::string_view::npos) {
+        req.path.assign(view.path.data(), view.path.size());
+    } else if (!decodePath(view.path, req.path)) {
+        return false;
+    }
+    req.queryString.assign(view.query.data(), view.query.size());
+    req.version.assign(view.version.data(), view.version.size());
+
+    req.headers.clear();
+    for (std::size_t i = 0; i < kKnownHeaderCount; ++i) {
+        if (view.known[i].data()) {
+            req.headers.insert_or_assign(std::string(knownHeaderKey(static_cast<KnownHeader>(i))),
+                                         std::string(view.known[i]));
         }
-        pos = lineEnd + 2;
     }
 
+    std::string key;
+    for (const auto& [name, value] : view.headers) {
+        // Normalize header key to lowercase for lookups
+        assignLowercase(key, name.data(), name.size());
+        req.headers.insert_or_assign(key, std::string(value));
+    }
     return true;
 }
 
@@ -11,40 +11,53 @@ void MiddlewareStack::useError(ErrorMiddleware errorMiddleware) {
     errorMiddlewares_.push_back(errorMiddleware);
 }
 
-void MiddlewareStack::run(Request& req, Response& res, std::function<void()> next) {
-    size_t index = 0;
-    Context context; // Shared context for all middleware
-    std::exception_ptr error = nullptr;
-
-    // Function to run error middleware
-    std::function<void()> runErrorHandlers = [&]() {
-        for (auto& errorMiddleware : errorMiddlewares_) {
-            errorMiddleware(error, req, res, context, next);
-        }
+void MiddlewareStack::run(Request& req, Response& res, std::function<void()> next) const {
+    if (middlewares_.empty()) {
+        next(); // Nothing to chain: skip building the context and closures
+        return;
+    }
+
+    // The chain's state lives as long as some middleware still holds its
+    // next function, so a coroutine middleware can resume the chain after
+    // run() has returned
+    struct Chain {
+        const MiddlewareStack& stack;
+        Request& req;
+        Response& res;
+        std::function<void()> next;
+        Context context; // Shared context for all middleware
+        size_t index = 0;
     };
+    auto chain = std::make_shared<Chain>(Chain{*this, req, res, std::move(next), Context(), 0});
 
-    // Function to run middleware sequentially
-    std::function<void(std::exception_ptr)> runNext = [&](std::exception_ptr err) {
-        if (err) {
-            error = err; // Store error and trigger error middleware
-            runErrorHandlers();
-            return;
-        }
+    struct RunNext {
+        std::shared_ptr<Chain> chain;
+
+        void operator()(std::exception_ptr err) const {
+            Chain& c = *chain;
+            if (err) {
+                // Trigger error middleware
+                for (auto& errorMiddleware : c.stack.errorMiddlewares_) {
+                    errorMiddleware(err, c.req, c.res, c.context, c.next);
+                }
+                return;
+            }
 
-        if (index < middlewares_.size()) {
-            auto& middleware = middlewares_[index++];
-            try {
-                middleware(req, res, context, runNext);
-            } catch (...) {
-                runNext(std::current_exception());
+            if (c.index < c.stack.middlewares_.size()) {
+                auto& middleware = c.stack.middlewares_[c.index++];
+                try {
+                    middleware(c.req, c.res, c.context, *this);
+                } catch (...) {
+                    (*this)(std::current_exception());
+                }
+            } else {
+                c.next(); // Call final handler
             }
-        } else {
-            next(); // Call final handler
         }
     };
 
     // Start middleware chain
-    runNext(nullptr);
+    RunNext{std::move(chain)}(nullptr);
 }
 
 } // namespace Http
@@ -0,0 +1,373 @@
+// File: Aether/Http/Multipart.cpp
+#include "Aether/Http/Multipart.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+constexpr std::size_t kMaxBoundaryLength = 70; // RFC 2046
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+inline std::string_view trim(std::string_view s) {
+    while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Calls visit(name, value) for each ";"-separated parameter after the first
+// element of a header value; quoted values are unquoted
+template <typename Visit>
+void forEachParameter(std::string_view value, Visit visit) {
+    std::size_t pos = value.find(';');
+    while (pos < value.size()) {
+        ++pos; // Past ';'
+        const std::size_t nameEnd = std::min(value.find_first_of("=;", pos), value.size());
+        const std::string_view name = trim(value.substr(pos, nameEnd - pos));
+        pos = nameEnd;
+        if (pos >= value.size() || value[pos] == ';') {
+            continue; // Parameter without a value
+        }
+        ++pos; // Past '='
+        while (pos < value.size() && isSpace(value[pos])) ++pos;
+
+        std::string parsed;
+        if (pos < value.size() && value[pos] == '"') {
+            for (++pos; pos < value.size() && value[pos] != '"'; ++pos) {
+                if (value[pos] == '\\' && pos + 1 < value.size()) {
+                    ++pos;
+                }
+                parsed.push_back(value[pos]);
+            }
+            pos = std::min(value.find(';', pos), value.size());
+        } else {
+            const std::size_t end = std::min(value.find(';', pos), value.size());
+            parsed.assign(trim(value.substr(pos, end - pos)));
+            pos = end;
+        }
+        visit(name, std::move(parsed));
+    }
+}
+
+} // anonymous namespace
+
+MultipartParser::MultipartParser(std::string_view boundary, std::size_t maxHeaderBytes)
+    : maxHeaderBytes_(maxHeaderBytes) {
+    if (boundary.empty() || boundary.size() > kMaxBoundaryLength) {
+        throw std::invalid_argument("Multipart boundary must be 1 to 70 characters");
+    }
+    delimiter_.reserve(4 + boundary.size());
+    delimiter_.append("\r\n--").append(boundary.data(), boundary.size());
+
+    const std::size_t last = delimiter_.size() - 1;
+    skip_.fill(static_cast<unsigned char>(delimiter_.size()));
+    for (std::size_t i = 0; i < last; ++i) {
+        skip_[static_cast<unsigned char>(delimiter_[i])] = static_cast<unsigned char>(last - i);
+    }
+
+    // The first boundary may start the body without a preceding CRLF
+    carry_ = "\r\n";
+}
+
+std::string MultipartParser::boundaryFrom(std::string_view contentType) {
+    constexpr std::string_view kMultipart = "multipart/";
+    if (contentType.size() <= kMultipart.size() ||
+        !equalsIgnoreCase(contentType.substr(0, kMultipart.size()), kMultipart)) {
+        return {};
+    }
+    std::string boundary;
+    forEachParameter(contentType, [&boundary](std::string_view name, std::string value) {
+        if (equalsIgnoreCase(name, "boundary")) {
+            boundary = std::move(value);
+        }
+    });
+    return boundary;
+}
+
+// Boyer-Moore-Horspool: on a mismatch, shift by how far the window's last
+// byte is from its last occurrence in the delimiter. Body bytes rarely occur
+// in it, so most windows are skipped whole after a single comparison.
+std::size_t MultipartParser::search(std::string_view haystack) const {
+    const std::size_t length = delimiter_.size();
+    if (haystack.size() < length) {
+        return std::string_view::npos;
+    }
+    const char* text = haystack.data();
+    const std::size_t last = length - 1;
+    const char lastChar = delimiter_[last];
+    const std::size_t limit = haystack.size() - length;
+
+    std::size_t i = 0;
+    while (i <= limit) {
+        const char c = text[i + last];
+        if (c == lastChar && std::memcmp(text + i, delimiter_.data(), last) == 0) {
+            return i;
+        }
+        i += skip_[static_cast<unsigned char>(c)];
+    }
+    return std::string_view::npos;
+}
+
+// Length of the longest tail of haystack that could be the start of a
+// delimiter continuing in the next piece
+std::size_t MultipartParser::partialSuffix(std::string_view haystack) const {
+    const std::size_t n = haystack.size();
+    for (std::size_t i = n - std::min(n, delimiter_.size() - 1); i < n; ++i) {
+        if (haystack[i] == '\r' && std::memcmp(haystack.data() + i, delimiter_.data(), n - i) == 0) {
+            return n - i;
+        }
+    }
+    return 0;
+}
+
+bool MultipartParser::feed(std::string_view data) {
+    while (!data.empty()) {
+        switch (state_) {
+        case State::Preamble:
+        case State::Body: {
+            if (!carry_.empty()) {
+                // Held-back bytes: a delimiter may straddle them and this piece
+                const std::size_t take = std::min(data.size(), delimiter_.size());
+                std::string joined = carry_;
+                joined.append(data.data(), take);
+                const std::size_t found = search(joined);
+                if (found != std::string_view::npos) {
+                    emit(std::string_view(joined).substr(0, found));
+                    data.remove_prefix(found + delimiter_.size() - carry_.size());
+                    carry_.clear();
+                    delimiterFound();
+                    break;
+                }
+                if (take == data.size()) {
+                    const std::size_t keep = partialSuffix(joined);
+                    emit(std::string_view(joined).substr(0, joined.size() - keep));
+                    carry_.assign(joined, joined.size() - keep, keep);
+                    return true;
+                }
+                emit(carry_); // No delimiter can start in it
+                carry_.clear();
+            }
+
+            const std::size_t found = search(data);
+            if (found != std::string_view::npos) {
+                emit(data.substr(0, found));
+                data.remove_prefix(found + delimiter_.size());
+                delimiterFound();
+                break;
+            }
+            const std::size_t keep = partialSuffix(data);
+            emit(data.substr(0, data.size() - keep));
+            carry_.assign(data.data() + data.size() - keep, keep);
+            return true;
+        }
+        case State::DelimiterEnd:
+            data.remove_prefix(feedDelimiterEnd(data));
+            break;
+        case State::Headers:
+            data.remove_prefix(feedHeaders(data));
+            break;
+        case State::Done:
+            return true; // Epilogue is ignored
+        case State::Error:
+            return false;
+        }
+    }
+    return state_ != State::Error;
+}
+
+void MultipartParser::emit(std::string_view data) {
+    // Preamble bytes are discarded
+    if (state_ == State::Body && !data.empty()) {
+        part_.size += data.size();
+        if (onPartData_) {
+            onPartData_(part_, data);
+        }
+    }
+}
+
+void MultipartParser::delimiterFound() {
+    if (state_ == State::Body && onPartEnd_) {
+        onPartEnd_(part_);
+    }
+    state_ = State::DelimiterEnd;
+    lastDelimiterChar_ = 0;
+}
+
+// After a delimiter: "--" closes the body, CRLF starts the next part's
+// headers; whitespace in between is transport padding
+std::size_t MultipartParser::feedDelimiterEnd(std::string_view data) {
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        const char c = data[i];
+        if (lastDelimiterChar_ == '-' || lastDelimiterChar_ == '\r') {
+            if (lastDelimiterChar_ == '-' && c == '-') {
+                state_ = State::Done;
+            } else if (lastDelimiterChar_ == '\r' && c == '\n') {
+                state_ = State::Headers;
+                headerBuffer_ = "\r\n"; // Lets an empty header block match "\r\n\r\n" too
+            } else {
+                fail("Malformed boundary line");
+            }
+            return i + 1;
+        }
+        if (c == '-' || c == '\r') {
+            lastDelimiterChar_ = c;
+        } else if (!isSpace(c)) {
+            fail("Malformed boundary line");
+            return i + 1;
+        }
+    }
+    return data.size();
+}
+
+std::size_t MultipartParser::feedHeaders(std::string_view data) {
+    const std::size_t previous = headerBuffer_.size();
+    const std::size_t capacity = maxHeaderBytes_ + 6; // Leading CRLF and blank line
+    const std::size_t take = std::min(data.size(), capacity - previous);
+    headerBuffer_.append(data.data(), take);
+
+    const std::size_t end = headerBuffer_.find("\r\n\r\n", previous < 3 ? 0 : previous - 3);
+    if (end == std::string::npos) {
+        if (headerBuffer_.size() >= capacity) {
+            fail("Part headers too large");
+        }
+        return take;
+    }
+
+    if (parsePartHeaders(std::string_view(headerBuffer_).substr(2, end))) {
+        state_ = State::Body;
+        if (onPartBegin_) {
+            onPartBegin_(part_);
+        }
+    }
+    headerBuffer_.clear();
+    return end + 4 - previous;
+}
+
+// Header lines of one part, each ending in CRLF
+bool MultipartParser::parsePartHeaders(std::string_view block) {
+    part_ = MultipartPart();
+    while (!block.empty()) {
+        const std::size_t lineEnd = block.find("\r\n");
+        const std::string_view line = block.substr(0, lineEnd);
+        block.remove_prefix(lineEnd + 2);
+
+        const std::size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0 || isSpace(line[0])) {
+            return fail("Malformed part header");
+        }
+        std::string name(trim(line.substr(0, colon)));
+        for (char& c : name) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+        }
+        const std::string_view value = trim(line.substr(colon + 1));
+
+        if (name == "content-disposition") {
+            forEachParameter(value, [this](std::string_view param, std::string parsed) {
+                if (equalsIgnoreCase(param, "name")) {
+                    part_.name = std::move(parsed);
+                } else if (equalsIgnoreCase(param, "filename")) {
+                    part_.filename = std::move(parsed);
+                }
+            });
+        } else if (name == "content-type") {
+            part_.contentType.assign(value.data(), value.size());
+        }
+        part_.headers.emplace_back(std::move(name), std::string(value));
+    }
+    return true;
+}
+
+bool MultipartParser::fail(const char* reason) {
+    state_ = State::Error;
+    error_ = reason;
+    return false;
+}
+
+const MultipartPart* MultipartForm::find(std::string_view name) const {
+    for (const auto& part : parts) {
+        if (part.name == name) {
+            return &part;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view MultipartForm::field(std::string_view name) const {
+    const MultipartPart* part = find(name);
+    return part ? part->content() : std::string_view();
+}
+
+bool receiveMultipart(Request& req, MultipartOptions options,
+                      std::function<void(MultipartForm&)> onComplete) {
+    const std::string boundary = MultipartParser::boundaryFrom(req.header(KnownHeader::ContentType));
+    if (boundary.empty() || boundary.size() > kMaxBoundaryLength) {
+        return false;
+    }
+    if (options.spillDirectory.empty()) {
+        options.spillDirectory = std::filesystem::temp_directory_path().string();
+    }
+
+    struct State {
+        State(const std::string& boundary, MultipartOptions opts)
+            : parser(boundary, opts.maxHeaderBytes), options(std::move(opts)) {}
+        MultipartParser parser;
+        MultipartOptions options;
+        MultipartForm form;
+    };
+    auto state = std::make_shared<State>(boundary, std::move(options));
+    State* s = state.get(); // The callbacks below live inside *state
+
+    s->parser.onPartBegin([s](MultipartPart&) {
+        if (s->form.parts.size() >= s->options.maxParts) {
+            s->form.error = "Too many parts";
+        }
+    });
+    s->parser.onPartData([s](MultipartPart& part, std::string_view data) {
+        const std::size_t threshold = s->options.spillThresholdBytes;
+        if (!part.file && threshold > 0 && part.data.size() + data.size() > threshold) {
+            part.file = std::make_shared<BodyFile>(s->options.spillDirectory);
+            part.file->append(part.data);
+            part.data.clear();
+            part.data.shrink_to_fit();
+        }
+        if (part.file) {
+            part.file->append(data);
+        } else {
+            part.data.append(data.data(), data.size());
+        }
+    });
+    s->parser.onPartEnd([s](MultipartPart& part) {
+        if (part.file) {
+            part.file->seal();
+        }
+        s->form.parts.push_back(std::move(part));
+    });
+
+    req.onData([state](std::string_view data) {
+        if (!state->form.error.empty()) {
+            return; // Already failed; drain the rest
+        }
+        if (!state->parser.feed(data)) {
+            state->form.error = state->parser.error();
+        }
+    });
+    req.onEnd([state, onComplete = std::move(onComplete)]() {
+        MultipartForm& form = state->form;
+        if (form.error.empty() && !state->parser.done()) {
+            form.error = "Body ended before the closing boundary";
+        }
+        form.complete = form.error.empty();
+        onComplete(form);
+    });
+    return true;
+}
+
+} // namespace Http
+} // namespace Aether
@@ -0,0 +1,591 @@
+// File: Aether/Http/RouteConstraint.cpp
+#include "Aether/Http/RouteConstraint.h"
+#include "Aether/Http/Url.h"
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <stdexcept>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+constexpr int kMaxRepeat = 100;          // Largest {n,m} bound accepted
+constexpr std::size_t kMaxNfaStates = 8192;
+constexpr std::size_t kMaxDfaStates = 1024;
+
+using ByteSet = std::bitset<256>;
+
+inline bool isHex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+inline bool isAlpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline bool isSlug(char c) {
+    return isAlpha(c) || (c >= '0' && c <= '9') || c == '-' || c == '_';
+}
+
+template <typename Predicate>
+inline bool allOf(std::string_view text, Predicate predicate) {
+    return !text.empty() && std::all_of(text.begin(), text.end(), predicate);
+}
+
+bool isUuid(std::string_view text) {
+    if (text.size() != 36) {
+        return false;
+    }
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (text[i] != '-') {
+                return false;
+            }
+        } else if (!isHex(text[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return c - 'A' + 10;
+}
+
+// The only byte in set, or -1 if it holds more or fewer than one
+int singleByte(const ByteSet& set) {
+    if (set.count() != 1) {
+        return -1;
+    }
+    int c = 0;
+    while (!set[c]) {
+        ++c;
+    }
+    return c;
+}
+
+ByteSet rangeSet(unsigned char first, unsigned char last) {
+    ByteSet set;
+    for (unsigned c = first; c <= last; ++c) {
+        set.set(c);
+    }
+    return set;
+}
+
+// Regex syntax tree. Nodes live in one vector and refer to each other by index.
+struct RegexNode {
+    enum Type { Set, Empty, Concat, Alternate, Repeat };
+    Type type;
+    ByteSet set{};
+    std::vector<std::size_t> children{};
+    int min = 0;
+    int max = 0; // -1 is unbounded
+};
+
+class RegexParser {
+public:
+    explicit RegexParser(std::string_view text) : text_(text) {}
+
+    // Parses the whole expression and returns the root node
+    std::size_t parse() {
+        if (!text_.empty() && text_.front() == '^') {
+            ++pos_; // Matching is anchored anyway
+        }
+        const std::size_t root = parseAlternate();
+        if (pos_ != text_.size()) {
+            fail("unbalanced ')'");
+        }
+        return root;
+    }
+
+    std::vector<RegexNode> nodes;
+
+private:
+    [[noreturn]] void fail(const char* what) const {
+        throw std::invalid_argument("Invalid route constraint '" + std::string(text_) + "': " + what);
+    }
+
+    bool atEnd() const { return pos_ == text_.size(); }
+
+    std::size_t add(RegexNode node) {
+        nodes.push_back(std::move(node));
+        return nodes.size() - 1;
+    }
+
+    std::size_t addSet(const ByteSet& set) {
+        RegexNode node{RegexNode::Set};
+        node.set = set;
+        return add(std::move(node));
+    }
+
+    std::size_t parseAlternate() {
+        std::vector<std::size_t> branches{parseConcat()};
+        while (!atEnd() && text_[pos_] == '|') {
+            ++pos_;
+            branches.push_back(parseConcat());
+        }
+        if (branches.size() == 1) {
+            return branches.front();
+        }
+        RegexNode node{RegexNode::Alternate};
+        node.children = std::move(branches);
+        return add(std::move(node));
+    }
+
+    std::size_t parseConcat() {
+        RegexNode node{RegexNode::Concat};
+        while (!atEnd() && text_[pos_] != '|' && text_[pos_] != ')') {
+            if (text_[pos_] == '$' && pos_ + 1 == text_.size()) {
+                ++pos_; // Trailing anchor; matching is anchored anyway
+                break;
+            }
+            node.children.push_back(parseRepeat());
+        }
+        if (node.children.empty()) {
+            return add(RegexNode{RegexNode::Empty});
+        }
+        if (node.children.size() == 1) {
+            return node.children.front();
+        }
+        return add(std::move(node));
+    }
+
+    std::size_t parseRepeat() {
+        const std::size_t atom = parseAtom();
+        if (atEnd()) {
+            return atom;
+        }
+
+        int min = 0;
+        int max = 0;
+        switch (text_[pos_]) {
+        case '*': min = 0; max = -1; ++pos_; break;
+        case '+': min = 1; max = -1; ++pos_; break;
+        case '?': min = 0; max = 1; ++pos_; break;
+        case '{': parseBounds(min, max); break;
+        default: return atom;
+        }
+        if (!atEnd() && (text_[pos_] == '?' || text_[pos_] == '+')) {
+            fail("lazy and possessive quantifiers are not supported");
+        }
+        if (!atEnd() && (text_[pos_] == '*' || text_[pos_] == '{')) {
+            fail("nothing to repeat");
+        }
+
+        RegexNode node{RegexNode::Repeat};
+        node.children.push_back(atom);
+        node.min = min;
+        node.max = max;
+        return add(std::move(node));
+    }
+
+    void parseBounds(int& min, int& max) {
+        const std::size_t close = text_.find('}', pos_);
+        if (close == std::string_view::npos) {
+            fail("unclosed '{'");
+        }
+        const std::string_view bounds = text_.substr(pos_ + 1, close - pos_ - 1);
+        pos_ = close + 1;
+
+        const std::size_t comma = bounds.find(',');
+        const auto low = parseNumber<int>(bounds.substr(0, comma));
+        if (!low || *low < 0) {
+            fail("bad repeat count");
+        }
+        min = *low;
+        if (comma == std::string_view::npos) {
+            max = min;
+        } else if (comma + 1 == bounds.size()) {
+            max = -1;
+        } else {
+            const auto high = parseNumber<int>(bounds.substr(comma + 1));
+            if (!high || *high < min) {
+                fail("bad repeat count");
+            }
+            max = *high;
+        }
+        if (min > kMaxRepeat || max > kMaxRepeat) {
+            fail("repeat count is too large");
+        }
+    }
+
+    std::size_t parseAtom() {
+        const char c = text_[pos_++];
+        switch (c) {
+        case '(': {
+            if (!atEnd() && text_[pos_] == '?') {
+                if (pos_ + 1 < text_.size() && text_[pos_ + 1] == ':') {
+                    pos_ += 2;
+                } else {
+                    fail("lookaround and group flags are not supported");
+                }
+            }
+            const std::size_t inner = parseAlternate();
+            if (atEnd() || text_[pos_] != ')') {
+                fail("unclosed '('");
+            }
+            ++pos_;
+            return inner;
+        }
+        case '[':
+            return addSet(parseClass());
+        case '.': {
+            ByteSet set;
+            set.set();
+            set.reset('\n');
+            set.reset('\r');
+            return addSet(set);
+        }
+        case '\\':
+            return addSet(parseEscape());
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            fail("nothing to repeat");
+        case '^':
+        case '$':
+            fail("anchors are only allowed at the ends");
+        default: {
+            ByteSet set;
+            set.set(static_cast<unsigned char>(c));
+            return addSet(set);
+        }
+        }
+    }
+
+    ByteSet parseEscape() {
+        if (atEnd()) {
+            fail("trailing '\\'");
+        }
+        const char c = text_[pos_++];
+        ByteSet set;
+        switch (c) {
+        case 'd': return rangeSet('0', '9');
+        case 'D': return ~rangeSet('0', '9');
+        case 'w': return wordSet();
+        case 'W': return ~wordSet();
+        case 's': return spaceSet();
+        case 'S': return ~spaceSet();
+        case 'n': set.set('\n'); return set;
+        case 'r': set.set('\r'); return set;
+        case 't': set.set('\t'); return set;
+        case 'f': set.set('\f'); return set;
+        case 'v': set.set('\v'); return set;
+        case 'x': {
+            if (text_.size() - pos_ < 2 || !isHex(text_[pos_]) || !isHex(text_[pos_ + 1])) {
+                fail("bad \\x escape");
+            }
+            set.set(static_cast<unsigned char>(hexValue(text_[pos_]) << 4 | hexValue(text_[pos_ + 1])));
+            pos_ += 2;
+            return set;
+        }
+        default:
+            if (c >= '1' && c <= '9') {
+                fail("backreferences are not supported");
+            }
+            if (isAlpha(c) || (c >= '0' && c <= '9')) {
+                fail("unknown escape");
+            }
+            set.set(static_cast<unsigned char>(c)); // Escaped punctuation
+            return set;
+        }
+    }
+
+    ByteSet parseClass() {
+        bool negate = false;
+        if (!atEnd() && text_[pos_] == '^') {
+            negate = true;
+            ++pos_;
+        }
+        ByteSet set;
+        bool first = true;
+        for (;;) {
+            if (atEnd()) {
+                fail("unclosed '['");
+            }
+            char c = text_[pos_];
+            if (c == ']' && !first) {
+                ++pos_;
+                break;
+            }
+            first = false;
+            ++pos_;
+
+            ByteSet item;
+            int low = -1;
+            if (c == '\\') {
+                item = parseEscape();
+                low = singleByte(item);
+            } else {
+                low = static_cast<unsigned char>(c);
+                item.set(low);
+            }
+
+            // A range: low '-' high, unless the '-' closes the class
+            if (low >= 0 && text_.size() - pos_ >= 2 && text_[pos_] == '-' && text_[pos_ + 1] != ']') {
+                ++pos_;
+                int high;
+                c = text_[pos_++];
+                if (c == '\\') {
+                    high = singleByte(parseEscape());
+                    if (high < 0) {
+                        fail("bad class range");
+                    }
+                } else {
+                    high = static_cast<unsigned char>(c);
+                }
+                if (high < low) {
+                    fail("bad class range");
+                }
+                item = rangeSet(static_cast<unsigned char>(low), static_cast<unsigned char>(high));
+            }
+            set |= item;
+        }
+        return negate ? ~set : set;
+    }
+
+    static ByteSet wordSet() {
+        ByteSet set = rangeSet('a', 'z') | rangeSet('A', 'Z') | rangeSet('0', '9');
+        set.set('_');
+        return set;
+    }
+
+    static ByteSet spaceSet() {
+        ByteSet set;
+        for (char c : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+            set.set(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    std::string_view text_;
+    std::size_t pos_ = 0;
+};
+
+// Thompson NFA: each state has at most one byte-set transition plus any
+// number of epsilon edges
+struct NfaState {
+    ByteSet set;
+    std::size_t target = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> epsilon;
+};
+
+class NfaBuilder {
+public:
+    explicit NfaBuilder(const std::vector<RegexNode>& nodes) : nodes_(nodes) {}
+
+    struct Fragment {
+        std::size_t start;
+        std::size_t end;
+    };
+
+    Fragment build(std::size_t index) {
+        const RegexNode& node = nodes_[index];
+        switch (node.type) {
+        case RegexNode::Set: {
+            const Fragment f{add(), add()};
+            states[f.start].set = node.set;
+            states[f.start].target = f.end;
+            return f;
+        }
+        case RegexNode::Empty: {
+            const std::size_t s = add();
+            return {s, s};
+        }
+        case RegexNode::Concat: {
+            Fragment f = build(node.children.front());
+            for (std::size_t i = 1; i < node.children.size(); ++i) {
+                const Fragment next = build(node.children[i]);
+                states[f.end].epsilon.push_back(next.start);
+                f.end = next.end;
+            }
+            return f;
+        }
+        case RegexNode::Alternate: {
+            const Fragment f{add(), add()};
+            for (std::size_t child : node.children) {
+                const Fragment branch = build(child);
+                states[f.start].epsilon.push_back(branch.start);
+                states[branch.end].epsilon.push_back(f.end);
+            }
+            return f;
+        }
+        case RegexNode::Repeat: {
+            const std::size_t child = node.children.front();
+            const std::size_t start = add();
+            std::size_t end = start;
+            for (int i = 0; i < node.min; ++i) {
+                const Fragment copy = build(child);
+                states[end].epsilon.push_back(copy.start);
+                end = copy.end;
+            }
+            if (node.max < 0) {
+                // Loop back to a state that is both entry and exit
+                const std::size_t loop = add();
+                const Fragment body = build(child);
+                states[end].epsilon.push_back(loop);
+                states[loop].epsilon.push_back(body.start);
+                states[body.end].epsilon.push_back(loop);
+                return {start, loop};
+            }
+            const std::size_t exit = add();
+            for (int i = node.min; i < node.max; ++i) {
+                const Fragment copy = build(child);
+                states[end].epsilon.push_back(copy.start);
+                states[end].epsilon.push_back(exit);
+                end = copy.end;
+            }
+            states[end].epsilon.push_back(exit);
+            return {start, exit};
+        }
+        }
+        return {0, 0};
+    }
+
+    std::vector<NfaState> states;
+
+private:
+    std::size_t add() {
+        if (states.size() == kMaxNfaStates) {
+            throw std::invalid_argument("Route constraint regex is too large");
+        }
+        states.emplace_back();
+        return states.size() - 1;
+    }
+
+    const std::vector<RegexNode>& nodes_;
+};
+
+// Sorted set of NFA states reachable from set through epsilon edges
+void closure(const std::vector<NfaState>& nfa, std::vector<std::size_t>& set) {
+    std::vector<bool> seen(nfa.size());
+    std::vector<std::size_t> stack(set);
+    set.clear();
+    while (!stack.empty()) {
+        const std::size_t s = stack.back();
+        stack.pop_back();
+        if (seen[s]) {
+            continue;
+        }
+        seen[s] = true;
+        set.push_back(s);
+        for (std::size_t next : nfa[s].epsilon) {
+            stack.push_back(next);
+        }
+    }
+    std::sort(set.begin(), set.end());
+}
+
+} // anonymous namespace
+
+std::shared_ptr<const RouteConstraint> RouteConstraint::parse(std::string_view text) {
+    static const std::pair<std::string_view, Kind> builtins[] = {
+        {"int", Kind::Int},   {"uint", Kind::Uint}, {"uuid", Kind::Uuid},
+        {"hex", Kind::Hex},   {"slug", Kind::Slug}, {"alpha", Kind::Alpha},
+    };
+    for (const auto& [name, kind] : builtins) {
+        if (text == name) {
+            return std::shared_ptr<const RouteConstraint>(new RouteConstraint(kind, text));
+        }
+    }
+    std::shared_ptr<RouteConstraint> constraint(new RouteConstraint(Kind::Regex, text));
+    constraint->compileRegex();
+    return constraint;
+}
+
+bool RouteConstraint::matches(std::string_view segment) const {
+    switch (kind_) {
+    case Kind::Int: return parseNumber<std::int64_t>(segment).has_value();
+    case Kind::Uint: return parseNumber<std::uint64_t>(segment).has_value();
+    case Kind::Uuid: return isUuid(segment);
+    case Kind::Hex: return allOf(segment, isHex);
+    case Kind::Slug: return allOf(segment, isSlug);
+    case Kind::Alpha: return allOf(segment, isAlpha);
+    case Kind::Regex: return matchRegex(segment);
+    }
+    return false;
+}
+
+void RouteConstraint::compileRegex() {
+    RegexParser parser(text_);
+    const std::size_t root = parser.parse();
+    NfaBuilder builder(parser.nodes);
+    const NfaBuilder::Fragment whole = builder.build(root);
+    const std::vector<NfaState>& nfa = builder.states;
+
+    // Split the bytes into classes that every transition treats alike
+    byteClass_.fill(0);
+    classCount_ = 1;
+    for (const NfaState& state : nfa) {
+        if (state.target == static_cast<std::size_t>(-1)) {
+            continue;
+        }
+        std::map<std::pair<unsigned char, bool>, unsigned char> refined;
+        for (unsigned c = 0; c < 256; ++c) {
+            const auto key = std::make_pair(byteClass_[c], bool(state.set[c]));
+            const auto it = refined.emplace(key, static_cast<unsigned char>(refined.size())).first;
+            byteClass_[c] = it->second;
+        }
+        classCount_ = refined.size();
+    }
+    std::vector<unsigned char> sample(classCount_);
+    for (unsigned c = 0; c < 256; ++c) {
+        sample[byteClass_[c]] = static_cast<unsigned char>(c);
+    }
+
+    // Subset construction; state 0 is the empty set, which never matches
+    std::map<std::vector<std::size_t>, std::uint16_t> ids{{{}, 0}};
+    std::vector<std::vector<std::size_t>> sets{{}};
+    std::vector<std::size_t> start{whole.start};
+    closure(nfa, start);
+
+    const auto intern = [&](std::vector<std::size_t>& set) -> std::uint16_t {
+        const auto it = ids.find(set);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        if (sets.size() == kMaxDfaStates) {
+            throw std::invalid_argument("Route constraint regex '" + text_ + "' is too complex");
+        }
+        const auto id = static_cast<std::uint16_t>(sets.size());
+        ids.emplace(set, id);
+        sets.push_back(std::move(set));
+        return id;
+    };
+
+    start_ = intern(start);
+    transitions_.assign(classCount_, 0); // Dead state loops on itself
+    accepting_.assign(1, false);
+    for (std::size_t d = 1; d < sets.size(); ++d) {
+        accepting_.push_back(std::binary_search(sets[d].begin(), sets[d].end(), whole.end));
+        for (std::size_t cls = 0; cls < classCount_; ++cls) {
+            std::vector<std::size_t> next;
+            for (std::size_t s : sets[d]) {
+                if (nfa[s].target != static_cast<std::size_t>(-1) && nfa[s].set[sample[cls]]) {
+                    next.push_back(nfa[s].target);
+                }
+            }
+            closure(nfa, next);
+            transitions_.push_back(intern(next)); // sets may grow; index d stays valid
+        }
+    }
+}
+
+bool RouteConstraint::matchRegex(std::string_view segment) const {
+    std::size_t state = start_;
+    for (char c : segment) {
+        state = transitions_[state * classCount_ + byteClass_[static_cast<unsigned char>(c)]];
+        if (state == 0) {
+            return false;
+        }
+    }
+    return accepting_[state];
+}
+
+} // namespace Http
+} // namespace Aether
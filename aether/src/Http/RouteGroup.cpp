@@ -0,0 +1,69 @@
+// File: Aether/Http/RouteGroup.cpp
+#include "Aether/Http/RouteGroup.h"
+#include "Aether/Http/Server.h"
+
+namespace Aether {
+namespace Http {
+
+RouteGroup::RouteGroup(Server& server, const std::string& prefix, std::string host)
+    : server_(server), prefix_(prefix), host_(std::move(host)) {
+    // Ensure the prefix starts with a '/' and does not end with one
+    if (!prefix_.empty() && prefix_[0] != '/') {
+        prefix_ = "/" + prefix_;
+    }
+    while (!prefix_.empty() && prefix_.back() == '/') {
+        prefix_.pop_back();
+    }
+}
+
+RouteGroup& RouteGroup::use(Middleware middleware) {
+    middleware_.push_back(std::move(middleware));
+    return *this;
+}
+
+RouteGroup RouteGroup::group(const std::string& prefix) const {
+    RouteGroup nested(server_, prefix, host_);
+    nested.prefix_.insert(0, prefix_);
+    nested.middleware_ = middleware_;
+    return nested;
+}
+
+RouteGroup& RouteGroup::get(const std::string& path, RequestHandler handler, RouteOptions options) {
+    return route(Method::Get, path, std::move(handler), std::move(options));
+}
+
+RouteGroup& RouteGroup::post(const std::string& path, RequestHandler handler, RouteOptions options) {
+    return route(Method::Post, path, std::move(handler), std::move(options));
+}
+
+RouteGroup& RouteGroup::put(const std::string& path, RequestHandler handler, RouteOptions options) {
+    return route(Method::Put, path, std::move(handler), std::move(options));
+}
+
+RouteGroup& RouteGroup::del(const std::string& path, RequestHandler handler, RouteOptions options) {
+    return route(Method::Delete, path, std::move(handler), std::move(options));
+}
+
+RouteGroup& RouteGroup::patch(const std::string& path, RequestHandler handler, RouteOptions options) {
+    return route(Method::Patch, path, std::move(handler), std::move(options));
+}
+
+RouteGroup& RouteGroup::head(const std::string& path, RequestHandler handler, RouteOptions options) {
+    return route(Method::Head, path, std::move(handler), std::move(options));
+}
+
+RouteGroup& RouteGroup::options(const std::string& path, RequestHandler handler, RouteOptions options) {
+    return route(Method::Options, path, std::move(handler), std::move(options));
+}
+
+RouteGroup& RouteGroup::route(Method method, const std::string& path, RequestHandler handler,
+                              RouteOptions options) {
+    // Group middleware runs ahead of the route's own
+    options.middleware.insert(options.middleware.begin(), middleware_.begin(), middleware_.end());
+    const std::string full = path.empty() || path[0] == '/' ? prefix_ + path : prefix_ + "/" + path;
+    server_.addRoute(host_, method, full.empty() ? "/" : full, std::move(handler), std::move(options));
+    return *this;
+}
+
+} // namespace Http
+} // namespace Aether
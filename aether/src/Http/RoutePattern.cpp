@@ -27,17 +27,18 @@ void RoutePattern::parsePattern(const std::string& pattern) {
                     throw std::invalid_argument("Invalid route pattern: " + pattern);
                 }
                 std::string name = segment.substr(1, regexStart - 1);
-                std::string regexStr = segment.substr(regexStart + 1, segment.size() - regexStart - 2);
-                segments_.push_back({Segment::Param, name, std::regex(regexStr)});
+                std::string_view constraint(segment);
+                constraint = constraint.substr(regexStart + 1, segment.size() - regexStart - 2);
+                segments_.push_back({Segment::Param, name, RouteConstraint::parse(constraint)});
             } else {
-                segments_.push_back({Segment::Param, segment.substr(1), std::regex()});
+                segments_.push_back({Segment::Param, segment.substr(1), nullptr});
             }
         } else if (segment[0] == '*' && segment.size() > 1) {
-            segments_.push_back({Segment::Wildcard, segment.substr(1), std::regex()});
+            segments_.push_back({Segment::Wildcard, segment.substr(1), nullptr});
         } else if (segment == "*") {
-            segments_.push_back({Segment::Wildcard, "*", std::regex()});
+            segments_.push_back({Segment::Wildcard, "*", nullptr});
         } else {
-            segments_.push_back({Segment::Static, segment, std::regex()});
+            segments_.push_back({Segment::Static, segment, nullptr});
         }
     }
 }
@@ -71,6 +72,7 @@ bool RoutePattern::match(const std::string& path,
         if (seg.type == Segment::Static) {
             if (pathSegments[pi] != seg.value) return false;
         } else if (seg.type == Segment::Param) {
+            if (seg.constraint && !seg.constraint->matches(pathSegments[pi])) return false;
             params[seg.value] = pathSegments[pi];
         }
 
@@ -79,42 +81,5 @@ bool RoutePattern::match(const std::string& path,
     return pi == pathSegments.size();
 }
 
-// RouteGroup Implementation
-
-RouteGroup::RouteGroup(const std::string& prefix) : prefix_(prefix) {
-    // Ensure the prefix starts with a '/' and does not end with one
-    if (!prefix_.empty() && prefix_[0] != '/') {
-        prefix_ = "/" + prefix_;
-    }
-    if (!prefix_.empty() && prefix_.back() == '/') {
-        prefix_.pop_back();
-    }
-}
-
-void RouteGroup::addRoute(const std::string& pattern, std::shared_ptr<RoutePattern> route) {
-    // Combine the group prefix with the route pattern
-    std::string fullPattern = prefix_ + pattern;
-    routes_.emplace_back(fullPattern, route);
-}
-
-bool RouteGroup::match(const std::string& path, std::unordered_map<std::string, std::string>& params) const {
-    // Check if the path starts with the group prefix
-    if (path.find(prefix_) != 0) {
-        return false;
-    }
-
-    // Remove the prefix from the path
-    std::string subPath = path.substr(prefix_.length());
-
-    // Match the subPath against the routes in the group
-    for (const auto& [pattern, route] : routes_) {
-        if (route->match(subPath, params)) {
-            return true;
-        }
-    }
-
-    return false;
-}
-
 } // namespace Http
 } // namespace Aether
\ No newline at end of file
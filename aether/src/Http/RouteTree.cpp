@@ -0,0 +1,273 @@
+// File: Aether/Http/RouteTree.cpp
+#include "Aether/Http/RouteTree.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+// Skips any '/' at pos and returns the next path segment, leaving pos just
+// past it. Returns an empty view once the path is exhausted, which also makes
+// "//" and trailing slashes match like their normalized form.
+inline std::string_view nextSegment(std::string_view path, std::size_t& pos) {
+    while (pos < path.size() && path[pos] == '/') {
+        ++pos;
+    }
+    const std::size_t start = pos;
+    const void* slash = std::memchr(path.data() + pos, '/', path.size() - pos);
+    pos = slash ? static_cast<std::size_t>(static_cast<const char*>(slash) - path.data())
+                : path.size();
+    return path.substr(start, pos - start);
+}
+
+} // anonymous namespace
+
+struct RouteTree::Node {
+    // ":name" child, taken only when the segment passes constraint (if any)
+    struct ParamEdge {
+        std::shared_ptr<const RouteConstraint> constraint;
+        std::unique_ptr<Node> node;
+    };
+
+    std::vector<std::string> label;              // Static segments consumed by this node
+    std::vector<std::unique_ptr<Node>> children; // Static children, sorted by label.front()
+    std::vector<ParamEdge> params;               // Constrained first, in registration order
+    std::size_t leaf = npos;                     // Route ending exactly here
+    std::size_t wildcardLeaf = npos;             // "*name" route rooted here
+
+    // Deep copy of this node and everything below it
+    std::unique_ptr<Node> clone() const {
+        auto copy = std::make_unique<Node>();
+        copy->label = label;
+        copy->children.reserve(children.size());
+        for (const auto& child : children) {
+            copy->children.push_back(child->clone());
+        }
+        copy->params.reserve(params.size());
+        for (const auto& edge : params) {
+            copy->params.push_back({edge.constraint, edge.node->clone()});
+        }
+        copy->leaf = leaf;
+        copy->wildcardLeaf = wildcardLeaf;
+        return copy;
+    }
+
+    // Returns the static child whose label starts with segment, or end()
+    std::vector<std::unique_ptr<Node>>::const_iterator findChild(std::string_view segment) const {
+        auto it = std::lower_bound(children.begin(), children.end(), segment,
+            [](const std::unique_ptr<Node>& child, std::string_view seg) {
+                return std::string_view(child->label.front()) < seg;
+            });
+        if (it != children.end() && (*it)->label.front() == segment) {
+            return it;
+        }
+        return children.end();
+    }
+
+    // Returns the parameter child for constraint, creating it if needed.
+    // Constraints compare by their text; the unconstrained child stays last.
+    Node& paramChild(const std::shared_ptr<const RouteConstraint>& constraint) {
+        for (auto& edge : params) {
+            if (constraint ? edge.constraint && edge.constraint->text() == constraint->text()
+                           : !edge.constraint) {
+                return *edge.node;
+            }
+        }
+        auto pos = params.end();
+        if (constraint && !params.empty() && !params.back().constraint) {
+            --pos;
+        }
+        return *params.insert(pos, {constraint, std::make_unique<Node>()})->node;
+    }
+};
+
+std::string_view RouteParams::get(std::string_view name) const {
+    for (const auto& param : *this) {
+        if (param.name == name) {
+            return param.value;
+        }
+    }
+    return {};
+}
+
+RouteTree::RouteTree() : root_(std::make_unique<Node>()) {}
+RouteTree::~RouteTree() = default;
+
+RouteTree::RouteTree(const RouteTree& other)
+    : root_(other.root_->clone()), leaves_(other.leaves_) {}
+
+RouteTree& RouteTree::operator=(const RouteTree& other) {
+    if (this != &other) {
+        root_ = other.root_->clone();
+        leaves_ = other.leaves_;
+    }
+    return *this;
+}
+
+RouteTree::RouteTree(RouteTree&&) noexcept = default;
+RouteTree& RouteTree::operator=(RouteTree&&) noexcept = default;
+
+std::size_t RouteTree::insert(const RoutePattern& pattern, std::size_t value) {
+    using Segment = RoutePattern::Segment;
+    const auto& segments = pattern.segments();
+
+    Node* node = root_.get();
+    std::vector<std::string> paramNames;
+    std::size_t* slot = nullptr;
+
+    std::size_t i = 0;
+    while (i < segments.size() && !slot) {
+        const Segment& segment = segments[i];
+
+        if (segment.type == Segment::Static) {
+            // Walk (and split) static edges for the whole run of static segments
+            std::size_t end = i;
+            while (end < segments.size() && segments[end].type == Segment::Static) {
+                ++end;
+            }
+
+            while (i < end) {
+                auto existing = node->findChild(segments[i].value);
+                if (existing == node->children.end()) {
+                    auto child = std::make_unique<Node>();
+                    for (; i < end; ++i) {
+                        child->label.push_back(segments[i].value);
+                    }
+                    auto pos = std::lower_bound(node->children.begin(), node->children.end(),
+                        child->label.front(),
+                        [](const std::unique_ptr<Node>& c, const std::string& seg) {
+                            return c->label.front() < seg;
+                        });
+                    node = node->children.insert(pos, std::move(child))->get();
+                    break;
+                }
+
+                auto& childPtr = node->children[existing - node->children.begin()];
+                std::size_t common = 0;
+                while (common < childPtr->label.size() && i + common < end &&
+                       childPtr->label[common] == segments[i + common].value) {
+                    ++common;
+                }
+
+                if (common < childPtr->label.size()) {
+                    // Split the edge: the shared prefix becomes its own node
+                    auto mid = std::make_unique<Node>();
+                    mid->label.assign(childPtr->label.begin(), childPtr->label.begin() + common);
+                    childPtr->label.erase(childPtr->label.begin(), childPtr->label.begin() + common);
+                    mid->children.push_back(std::move(childPtr));
+                    childPtr = std::move(mid);
+                }
+
+                node = childPtr.get();
+                i += common;
+            }
+        } else if (segment.type == Segment::Param) {
+            paramNames.push_back(segment.value);
+            node = &node->paramChild(segment.constraint);
+            ++i;
+        } else {
+            // A wildcard swallows the rest of the path; later segments are ignored
+            paramNames.push_back(segment.value);
+            slot = &node->wildcardLeaf;
+        }
+    }
+
+    if (!slot) {
+        slot = &node->leaf;
+    }
+    if (paramNames.size() > RouteParams::kMaxParams) {
+        throw std::invalid_argument("Too many parameters in route pattern");
+    }
+    if (*slot != npos) {
+        return leaves_[*slot].value;
+    }
+
+    leaves_.push_back({value, std::move(paramNames)});
+    *slot = leaves_.size() - 1;
+    return value;
+}
+
+std::size_t RouteTree::find(std::string_view path, RouteParams& params) const {
+    params.clear();
+
+    std::size_t leaf = npos;
+    if (!match(*root_, path, 0, params, leaf)) {
+        params.clear();
+        return npos;
+    }
+
+    const auto& names = leaves_[leaf].paramNames;
+    for (std::size_t i = 0; i < params.size_; ++i) {
+        params.params_[i].name = names[i];
+    }
+    return leaves_[leaf].value;
+}
+
+bool RouteTree::match(const Node& node, std::string_view path, std::size_t pos,
+                      RouteParams& params, std::size_t& leaf) const {
+    std::size_t cursor = pos;
+    const std::string_view segment = nextSegment(path, cursor);
+
+    if (segment.empty()) {
+        if (node.leaf != npos) {
+            leaf = node.leaf;
+            return true;
+        }
+        if (node.wildcardLeaf != npos && params.size_ < RouteParams::kMaxParams) {
+            params.params_[params.size_++].value = {};
+            leaf = node.wildcardLeaf;
+            return true;
+        }
+        return false;
+    }
+
+    // 1. Static edge
+    auto child = node.findChild(segment);
+    if (child != node.children.end()) {
+        const Node& next = **child;
+        std::size_t childPos = cursor;
+        bool labelMatches = true;
+        for (std::size_t i = 1; i < next.label.size(); ++i) {
+            if (nextSegment(path, childPos) != next.label[i]) {
+                labelMatches = false;
+                break;
+            }
+        }
+        if (labelMatches && match(next, path, childPos, params, leaf)) {
+            return true;
+        }
+    }
+
+    // 2. Parameters, constrained ones first
+    if (params.size_ < RouteParams::kMaxParams) {
+        for (const auto& edge : node.params) {
+            if (edge.constraint && !edge.constraint->matches(segment)) {
+                continue;
+            }
+            params.params_[params.size_++].value = segment;
+            if (match(*edge.node, path, cursor, params, leaf)) {
+                return true;
+            }
+            --params.size_;
+        }
+    }
+
+    // 3. Wildcard: everything from this segment on, minus trailing slashes
+    if (node.wildcardLeaf != npos && params.size_ < RouteParams::kMaxParams) {
+        std::string_view rest = path.substr(cursor - segment.size());
+        while (!rest.empty() && rest.back() == '/') {
+            rest.remove_suffix(1);
+        }
+        params.params_[params.size_++].value = rest;
+        leaf = node.wildcardLeaf;
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace Http
+} // namespace Aether
@@ -4,20 +4,36 @@
 namespace Aether {
 namespace Http {
 
+void Router::use(Middleware middleware) {
+    group_.use(std::move(middleware));
+}
+
 void Router::get(const std::string& route, std::function<void(Request&, Response&)> handler) {
-    app.get(basePath + route, handler);
+    group_.get(route, handler);
 }
 
 void Router::post(const std::string& route, std::function<void(Request&, Response&)> handler) {
-    app.post(basePath + route, handler);
+    group_.post(route, handler);
 }
 
 void Router::put(const std::string& route, std::function<void(Request&, Response&)> handler) {
-    app.put(basePath + route, handler);
+    group_.put(route, handler);
 }
 
 void Router::del(const std::string& route, std::function<void(Request&, Response&)> handler) {
-    app.del(basePath + route, handler);
+    group_.del(route, handler);
+}
+
+void Router::patch(const std::string& route, std::function<void(Request&, Response&)> handler) {
+    group_.patch(route, handler);
+}
+
+void Router::head(const std::string& route, std::function<void(Request&, Response&)> handler) {
+    group_.head(route, handler);
+}
+
+void Router::options(const std::string& route, std::function<void(Request&, Response&)> handler) {
+    group_.options(route, handler);
 }
 
 } // namespace Http
@@ -1,43 +1,182 @@
 // Server.cpp
 #include "Aether/Http/Server.h"
+#include <filesystem>
+#include <stdexcept>
 #include "Aether/Http/Connection.h"
 #include "Aether/NeuralDb/NeuralDbServer.h"
 
 namespace Aether {
 namespace Http {
 
+namespace {
+
+#ifdef SO_REUSEPORT
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+constexpr bool kHasReusePort = true;
+#else
+constexpr bool kHasReusePort = false;
+#endif
+
+// Host header value as a lookup key: lowercase, without the port or a
+// trailing dot. Writes into out, reusing its capacity.
+void normalizeHost(std::string_view host, std::string& out) {
+    if (!host.empty() && host.front() == '[') {
+        host = host.substr(0, host.find(']') + 1); // IPv6 literal
+    } else {
+        host = host.substr(0, host.find(':'));
+    }
+    if (!host.empty() && host.back() == '.') {
+        host.remove_suffix(1);
+    }
+    out.assign(host.data(), host.size());
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+    }
+}
+
+// Generations are unique across Servers, so a thread's cached table can
+// never be mistaken for another Server's
+std::atomic<std::uint64_t> lastRoutesGeneration{0};
+
+// This thread's copy of the most recent table it looked up in
+thread_local RoutePin threadRoutes;
+
+} // anonymous namespace
+
 Server::Server()
-    : eventLoop_(),
-      acceptor_(eventLoop_.getIoContext()) {
+    : eventLoop_() {
+    autoOptions_.handler = [this](Request& req, Response& res) {
+        RoutePin pin;
+        const RouteTable* snapshot = pinRoutes(pin);
+        const std::string_view path = req.zeroCopy() ? req.view.path : std::string_view(req.path);
+        res.setHeader("Allow", allowedMethods(hostRoutes(*snapshot, req), path));
+        res.send("", 200);
+    };
     eventLoop_.start();
 }
 
 Server::~Server() {
-    if (acceptor_.is_open()) acceptor_.close();
+    for (auto& acceptor : acceptors_) {
+        if (acceptor->is_open()) acceptor->close();
+    }
 }
 
 void Server::use(Middleware middleware) {
     middlewareStack_.use(middleware);
 }
 
-void Server::get(const std::string& path, RequestHandler handler) {
-    std::lock_guard<std::mutex> lock(handlersMutex_);
-    getHandlers_.push_back({RoutePattern(path), handler});
+RouteGroup Server::group(const std::string& prefix) {
+    return RouteGroup(*this, prefix);
 }
 
-void Server::post(const std::string& path, RequestHandler handler) {
-    std::lock_guard<std::mutex> lock(handlersMutex_);
-    postHandlers_.push_back({RoutePattern(path), handler});
+RouteGroup Server::vhost(const std::string& host) {
+    std::string name;
+    normalizeHost(host, name);
+    const std::size_t star = name.rfind('*');
+    if (name.empty() || name == "*." ||
+        (star != std::string::npos && (star != 0 || name.compare(0, 2, "*.") != 0))) {
+        throw std::invalid_argument("Invalid virtual host: " + host);
+    }
+    return RouteGroup(*this, "", std::move(name));
 }
 
-void Server::put(const std::string& path, RequestHandler handler) {
-    std::lock_guard<std::mutex> lock(handlersMutex_);
-    putHandlers_.push_back({RoutePattern(path), handler});
+void Server::get(const std::string& path, RequestHandler handler, RouteOptions options) {
+    route(Method::Get, path, std::move(handler), options);
+}
+
+void Server::post(const std::string& path, RequestHandler handler, RouteOptions options) {
+    route(Method::Post, path, std::move(handler), options);
+}
+
+void Server::put(const std::string& path, RequestHandler handler, RouteOptions options) {
+    route(Method::Put, path, std::move(handler), options);
+}
+
+void Server::del(const std::string& path, RequestHandler handler, RouteOptions options) {
+    route(Method::Delete, path, std::move(handler), options);
+}
+
+void Server::patch(const std::string& path, RequestHandler handler, RouteOptions options) {
+    route(Method::Patch, path, std::move(handler), options);
+}
+
+void Server::head(const std::string& path, RequestHandler handler, RouteOptions options) {
+    route(Method::Head, path, std::move(handler), options);
+}
+
+void Server::options(const std::string& path, RequestHandler handler, RouteOptions options) {
+    route(Method::Options, path, std::move(handler), options);
 }
 
-void Server::del(const std::string& path, RequestHandler handler) {
+void Server::route(Method method, const std::string& path, RequestHandler handler,
+                   RouteOptions options) {
+    addRoute({}, method, path, std::move(handler), std::move(options));
+}
+
+void Server::addRoute(const std::string& host, Method method, const std::string& path,
+                      RequestHandler handler, RouteOptions options) {
+    if (method >= Method::Count) {
+        throw std::invalid_argument("Unknown request method");
+    }
+    RoutePattern pattern(path);
+    std::shared_ptr<MiddlewareStack> middleware;
+    if (!options.middleware.empty()) {
+        middleware = std::make_shared<MiddlewareStack>();
+        for (auto& m : options.middleware) {
+            middleware->use(std::move(m));
+        }
+        options.middleware.clear(); // Held by the stack from here on
+    }
+    const bool blocking = options.runBlocking;
+    auto route = std::make_shared<Route>(
+        Route{std::move(handler), std::move(options), std::move(middleware)});
+
     std::lock_guard<std::mutex> lock(handlersMutex_);
-    deleteHandlers_.push_back({RoutePattern(path), handler});
+    if (blocking) {
+        if (!blocking_) {
+            blocking_ = std::make_unique<BlockingExecutor>();
+        }
+        route->blocking = blocking_.get();
+    }
+    std::shared_ptr<const Route> shared = std::move(route);
+    MethodTable& table = host.empty() ? draftRoutes_.routes
+                       : host.compare(0, 2, "*.") == 0 ? draftRoutes_.domains[host.substr(2)]
+                       : draftRoutes_.hosts[host];
+    MethodRoutes& routes = table[methodIndex(method)];
+    const std::size_t index = routes.routes.size();
+    const std::size_t existing = routes.tree.insert(pattern, index);
+    if (existing == index) {
+        routes.routes.push_back(std::move(shared));
+    } else {
+        routes.routes[existing] = std::move(shared); // Re-registering replaces
+    }
+
+    // Nothing reads the table before run(), so startup registrations are
+    // batched into the first snapshot instead of publishing one per route
+    if (routes_) {
+        publishRoutes();
+    }
+}
+
+void Server::publishRoutes() {
+    // Caller holds handlersMutex_
+    routes_ = std::make_shared<const RouteTable>(draftRoutes_);
+    routesGeneration_.store(lastRoutesGeneration.fetch_add(1, std::memory_order_relaxed) + 1,
+                            std::memory_order_release);
+}
+
+const Server::RouteTable* Server::pinRoutes(RoutePin& pin) const {
+    const std::uint64_t generation = routesGeneration_.load(std::memory_order_acquire);
+    if (pin.generation != generation) {
+        if (threadRoutes.generation != generation) {
+            // Once per thread per publish
+            std::lock_guard<std::mutex> lock(handlersMutex_);
+            threadRoutes.generation = routesGeneration_.load(std::memory_order_relaxed);
+            threadRoutes.table = routes_;
+        }
+        pin = threadRoutes; // Once per connection per publish
+    }
+    return static_cast<const RouteTable*>(pin.table.get());
 }
 
 void Server::views(const std::string& folder) {
@@ -45,20 +184,99 @@ void Server::views(const std::string& folder) {
     Response::viewsFolder_ = folder;
 }
 
+void Server::sharded(std::size_t workers) {
+    eventLoop_.stop();
+    eventLoop_.startSharded(workers);
+}
+
+void Server::zeroCopyRequests(bool enabled) {
+    connectionOptions_.zeroCopyRequests = enabled;
+}
+
+void Server::spillBodies(std::size_t thresholdBytes, std::string directory) {
+    if (directory.empty()) {
+        directory = std::filesystem::temp_directory_path().string();
+    }
+    connectionOptions_.spillThresholdBytes = thresholdBytes;
+    connectionOptions_.spillDirectory = std::move(directory);
+}
+
+void Server::timeouts(const ConnectionTimeouts& timeouts) {
+    connectionOptions_.timeouts = timeouts;
+}
+
+void Server::blockingPool(BlockingExecutor::Options options) {
+    std::lock_guard<std::mutex> lock(handlersMutex_);
+    if (blocking_) {
+        throw std::logic_error("blockingPool() must be called before any blocking route is registered");
+    }
+    blocking_ = std::make_unique<BlockingExecutor>(options);
+}
+
+BlockingExecutor& Server::blockingExecutor() {
+    std::lock_guard<std::mutex> lock(handlersMutex_);
+    if (!blocking_) {
+        blocking_ = std::make_unique<BlockingExecutor>();
+    }
+    return *blocking_;
+}
+
+BlockingExecutor::Stats Server::blockingStats() const {
+    std::lock_guard<std::mutex> lock(handlersMutex_);
+    return blocking_ ? blocking_->stats() : BlockingExecutor::Stats{};
+}
+
 void Server::run(int port) {
     try {
         boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port);
-        acceptor_.open(endpoint.protocol());
-        acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        acceptor_.bind(endpoint);
-        acceptor_.listen(boost::asio::socket_base::max_listen_connections);
-        startAccept();
+
+        {
+            std::lock_guard<std::mutex> lock(handlersMutex_);
+            publishRoutes();
+        }
+
+        const bool perShardListeners = eventLoop_.isSharded() && kHasReusePort;
+        const std::size_t numListeners = perShardListeners ? eventLoop_.shardCount() : 1;
+
+        for (std::size_t shard = 0; shard < numListeners; ++shard) {
+            acceptors_.push_back(std::make_unique<boost::asio::ip::tcp::acceptor>(
+                eventLoop_.getIoContext(shard)));
+            listen(*acceptors_.back(), endpoint, perShardListeners);
+        }
+        for (std::size_t shard = 0; shard < numListeners; ++shard) {
+            startAccept(*acceptors_[shard], shard);
+        }
         eventLoop_.keepAlive(); // Block here
     } catch (const std::exception& e) {
         // Handle error
     }
 }
 
+void Server::stop() {
+    eventLoop_.stop(); // keepAlive() in run() returns once the loop is down
+    for (auto& acceptor : acceptors_) {
+        boost::system::error_code ec;
+        acceptor->close(ec); // No I/O thread is left to race with
+    }
+}
+
+void Server::listen(boost::asio::ip::tcp::acceptor& acceptor,
+                    const boost::asio::ip::tcp::endpoint& endpoint,
+                    bool reusePort) {
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+    if (reusePort) {
+        // The kernel load-balances new connections across all listeners
+        acceptor.set_option(reuse_port(true));
+    }
+#else
+    (void)reusePort;
+#endif
+    acceptor.bind(endpoint);
+    acceptor.listen(boost::asio::socket_base::max_listen_connections);
+}
+
 void Server::neural(int port) {
     if (neuraldbRunning_) return;
     neuraldbRunning_ = true;
@@ -80,38 +298,118 @@ void Server::neural(int port) {
     });
 }
 
-RequestHandler Server::findHandler(const std::string& method, const std::string& path, Request& req) {
-    std::lock_guard<std::mutex> lock(handlersMutex_);
-    
-    const auto& routes = [&]() -> const std::vector<Route>& {
-        if (method == "GET") return getHandlers_;
-        if (method == "POST") return postHandlers_;
-        if (method == "PUT") return putHandlers_;
-        return deleteHandlers_;
-    }();
-
-    for (const auto& route : routes) {
+const Server::MethodTable& Server::hostRoutes(const RouteTable& table, const Request& req) const {
+    if (table.hosts.empty() && table.domains.empty()) {
+        return table.routes; // No virtual hosts: skip reading the header
+    }
+
+    // Reused per thread, so the lookup does not allocate
+    thread_local std::string host;
+    normalizeHost(req.view.header(KnownHeader::Host), host);
+    const auto exact = table.hosts.find(host);
+    if (exact != table.hosts.end()) {
+        return exact->second;
+    }
+
+    // Closest wildcard first: a.b.example.com tries b.example.com, then example.com
+    if (!table.domains.empty()) {
+        thread_local std::string domain;
+        for (std::size_t dot = host.find('.'); dot != std::string::npos; dot = host.find('.', dot + 1)) {
+            domain.assign(host, dot + 1, std::string::npos);
+            const auto wildcard = table.domains.find(domain);
+            if (wildcard != table.domains.end()) {
+                return wildcard->second;
+            }
+        }
+    }
+    return table.routes;
+}
+
+std::string Server::allowedMethods(const MethodTable& table, std::string_view path) const {
+    RouteParams params;
+    const auto matches = [&](Method method) {
+        const MethodRoutes& routes = table[methodIndex(method)];
+        return path == "*" ? !routes.routes.empty()
+                           : routes.tree.find(path, params) != RouteTree::npos;
+    };
+
+    std::string allow;
+    for (std::size_t i = 0; i < kMethodCount; ++i) {
+        const auto method = static_cast<Method>(i);
+        // HEAD follows GET, and OPTIONS (last) is answered wherever anything is
+        const bool allowed = matches(method) ||
+                             (method == Method::Head && matches(Method::Get)) ||
+                             (method == Method::Options && !allow.empty());
+        if (allowed) {
+            if (!allow.empty()) {
+                allow.append(", ");
+            }
+            allow.append(methodName(method));
+        }
+    }
+    return allow;
+}
+
+const Route* Server::findRoute(Method method, std::string_view path, Request& req, RoutePin& pin) {
+    const RouteTable* snapshot = pinRoutes(pin);
+    if (!snapshot || method >= Method::Count) {
+        return nullptr;
+    }
+
+    const MethodTable& table = hostRoutes(*snapshot, req);
+    const MethodRoutes* routes = &table[methodIndex(method)];
+    std::size_t index = routes->tree.find(path, req.view.params);
+    if (index == RouteTree::npos) {
+        if (method == Method::Head) {
+            // HEAD runs the GET route; the connection leaves the body out
+            routes = &table[methodIndex(Method::Get)];
+            index = routes->tree.find(path, req.view.params);
+        } else if (method == Method::Options && !allowedMethods(table, path).empty()) {
+            return &autoOptions_;
+        }
+        if (index == RouteTree::npos) {
+            return nullptr;
+        }
+    }
+
+    if (!connectionOptions_.zeroCopyRequests) {
         req.params.clear();
-        if (route.pattern.match(path, req.params)) {
-            return route.handler;
+        for (const auto& param : req.view.params) {
+            req.params.emplace(param.name, param.value);
         }
     }
-    return nullptr;
+    return routes->routes[index].get();
 }
 
-void Server::startAccept() {
-    auto socket = std::make_shared<boost::asio::ip::tcp::socket>(eventLoop_.getIoContext());
-    
-    acceptor_.async_accept(*socket,
-        [this, socket](const boost::system::error_code& error) {
-            handleNewConnection(error, socket);
-            startAccept();
+void Server::startAccept(boost::asio::ip::tcp::acceptor& acceptor, std::size_t shard) {
+    // With per-shard listeners the socket stays on the acceptor's own shard;
+    // a single listener in sharded mode spreads sockets over the shards instead.
+    const bool spread = eventLoop_.isSharded() && acceptors_.size() == 1;
+    const std::size_t target = spread
+        ? nextShard_.fetch_add(1, std::memory_order_relaxed)
+        : shard;
+
+    // A connection's handlers, timeouts and deferred completions all run on
+    // its socket's executor. Several threads run a shared io_context, so
+    // that is a strand there; a shard has a single thread and needs none.
+    boost::asio::io_context& ioContext = eventLoop_.getIoContext(target);
+    const boost::asio::any_io_executor executor = eventLoop_.isSharded()
+        ? boost::asio::any_io_executor(ioContext.get_executor())
+        : boost::asio::any_io_executor(boost::asio::make_strand(ioContext));
+    acceptor.async_accept(executor,
+        [this, &acceptor, &ioContext, shard](const boost::system::error_code& error,
+                                             boost::asio::ip::tcp::socket socket) {
+            handleNewConnection(error, std::move(socket), ioContext);
+            if (acceptor.is_open()) {
+                startAccept(acceptor, shard);
+            }
         });
 }
 
 void Server::handleNewConnection(
     const boost::system::error_code& error,
-    std::shared_ptr<boost::asio::ip::tcp::socket> socket
+    boost::asio::ip::tcp::socket socket,
+    boost::asio::io_context& ioContext
 ) {
     if (error) {
         return;
@@ -120,21 +418,25 @@ void Server::handleNewConnection(
     if (activeConnections_ < maxConnections_) {
         ++activeConnections_;
         std::make_shared<Connection>(
-            std::move(*socket),
-            [this](auto&& method, auto&& path, auto&& req) { 
-                return findHandler(method, path, req); 
+            std::move(socket),
+            [this](auto&& method, auto&& path, auto&& req, auto&& pin) {
+                return findRoute(method, path, req, pin);
             },
             middlewareStack_,
-            [this] { --activeConnections_; }
+            [this] { --activeConnections_; },
+            // A shard's one thread owns its wheel; a shared io_context has
+            // several threads, so each connection keeps its own timer there
+            eventLoop_.isSharded() ? &boost::asio::use_service<TimerService>(ioContext) : nullptr,
+            connectionOptions_
         )->start();
         return;
     }
 
     // At capacity: close politely without holding up the accept loop
-    if (socket->is_open()) {
+    if (socket.is_open()) {
         boost::system::error_code ec;
-        socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
-        socket->close(ec);
+        socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        socket.close(ec);
     }
 }
 
@@ -0,0 +1,161 @@
+// File: Aether/Http/TimerWheel.cpp
+#include "Aether/Http/TimerWheel.h"
+
+namespace Aether {
+namespace Http {
+
+TimerWheel::TimerWheel() {
+    for (auto& level : slots_) {
+        for (Entry& head : level) {
+            head.prev_ = &head;
+            head.next_ = &head;
+        }
+    }
+}
+
+void TimerWheel::schedule(Entry& entry, std::uint64_t expiry) {
+    if (entry.scheduled()) {
+        unlink(entry);
+    }
+    entry.expiry_ = std::max(expiry, now_ + 1);
+    link(entry);
+}
+
+void TimerWheel::cancel(Entry& entry) {
+    if (entry.scheduled()) {
+        unlink(entry);
+    }
+}
+
+void TimerWheel::clear() {
+    for (auto& level : slots_) {
+        for (Entry& head : level) {
+            while (head.next_ != &head) {
+                unlink(*head.next_);
+            }
+        }
+    }
+}
+
+void TimerWheel::link(Entry& entry) {
+    // The lowest level whose span covers the distance; an entry due now (only
+    // while cascading) lands in the level 0 slot about to be emptied
+    const std::uint64_t distance = entry.expiry_ > now_ ? entry.expiry_ - now_ : 0;
+    std::size_t level = 0;
+    while (level + 1 < kLevels && distance >> ((level + 1) * kLevelBits) != 0) {
+        ++level;
+    }
+    std::uint64_t tick = entry.expiry_;
+    if (distance >> (kLevels * kLevelBits) != 0) {
+        tick = now_ + (std::uint64_t{1} << (kLevels * kLevelBits)) - 1; // Too far: as far as the wheel reaches
+    }
+
+    Entry& head = slots_[level][slotIndex(tick, level)];
+    entry.prev_ = head.prev_;
+    entry.next_ = &head;
+    head.prev_->next_ = &entry;
+    head.prev_ = &entry;
+    ++size_;
+}
+
+void TimerWheel::unlink(Entry& entry) {
+    entry.prev_->next_ = entry.next_;
+    entry.next_->prev_ = entry.prev_;
+    entry.prev_ = nullptr;
+    entry.next_ = nullptr;
+    --size_;
+}
+
+void TimerWheel::cascade(std::size_t level) {
+    // Detach the slot first so entries relinked into it are not revisited
+    Entry& head = slots_[level][slotIndex(now_, level)];
+    if (head.next_ == &head) {
+        return;
+    }
+    Entry* entry = head.next_;
+    head.prev_->next_ = nullptr;
+    head.prev_ = &head;
+    head.next_ = &head;
+    while (entry != nullptr) {
+        Entry* next = entry->next_;
+        --size_;
+        link(*entry);
+        entry = next;
+    }
+}
+
+boost::asio::io_context::id TimerService::id;
+
+TimerService::TimerService(boost::asio::io_context& context)
+    : boost::asio::io_context::service(context),
+      timer_(context),
+      start_(std::chrono::steady_clock::now()) {}
+
+std::uint64_t TimerService::ticksSinceStart() const {
+    return static_cast<std::uint64_t>((std::chrono::steady_clock::now() - start_) / kResolution);
+}
+
+void TimerService::schedule(TimerWheel::Entry& entry, std::chrono::milliseconds delay) {
+    // Rounded up, so the deadline passes before the entry fires
+    const auto due = std::chrono::steady_clock::now() - start_ + delay + kResolution - std::chrono::nanoseconds(1);
+    const auto expiry = static_cast<std::uint64_t>(due / kResolution);
+
+    if (entry.scheduled() && entry.expiry() == expiry) {
+        return; // Re-armed within the same tick: nothing moves
+    }
+    if (wheel_.size() == 0) {
+        wheel_.advance(ticksSinceStart(), [](TimerWheel::Entry&) {});
+    }
+    wheel_.schedule(entry, expiry);
+    if (!ticking_) {
+        startTicking();
+    }
+}
+
+void TimerService::cancel(TimerWheel::Entry& entry) {
+    wheel_.cancel(entry);
+}
+
+std::size_t TimerService::size() {
+    return wheel_.size();
+}
+
+void TimerService::startTicking() {
+    ticking_ = true;
+    timer_.expires_at(start_ + kResolution * (wheel_.now() + 1));
+    timer_.async_wait([this](const boost::system::error_code& error) {
+        if (!error) {
+            onTick();
+        }
+    });
+}
+
+void TimerService::onTick() {
+    // Collected first: a callback may schedule or cancel other entries
+    std::vector<std::function<void()>> expired;
+    // Catches up on ticks missed while the loop was busy
+    wheel_.advance(ticksSinceStart(), [&expired](TimerWheel::Entry& entry) {
+        expired.push_back(entry.onExpire);
+    });
+    ticking_ = false;
+    if (wheel_.size() > 0) {
+        startTicking();
+    }
+
+    // The owners may be gone by now; callbacks are expected to hold weak
+    // references
+    for (auto& callback : expired) {
+        if (callback) {
+            callback();
+        }
+    }
+}
+
+void TimerService::shutdown() {
+    wheel_.clear();
+    ticking_ = false;
+    timer_.cancel();
+}
+
+} // namespace Http
+} // namespace Aether
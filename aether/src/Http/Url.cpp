@@ -0,0 +1,115 @@
+// File: Aether/Http/Url.cpp
+#include "Aether/Http/Url.h"
+#include <cstring>
+
+namespace Aether {
+namespace Http {
+
+namespace {
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Position of the next byte that needs decoding at or after pos, or
+// text.size(). memchr scans a vector register at a time, and the literal
+// runs in between are copied with a single append.
+inline std::size_t nextEscape(std::string_view text, std::size_t pos) {
+    const void* found = std::memchr(text.data() + pos, '%', text.size() - pos);
+    return found ? static_cast<std::size_t>(static_cast<const char*>(found) - text.data())
+                 : text.size();
+}
+
+} // anonymous namespace
+
+bool decodePath(std::string_view path, std::string& out) {
+    out.clear();
+    out.reserve(path.size());
+    std::size_t pos = 0;
+    for (;;) {
+        const std::size_t escape = nextEscape(path, pos);
+        out.append(path.data() + pos, escape - pos);
+        if (escape == path.size()) {
+            return true;
+        }
+        if (path.size() - escape < 3) {
+            return false;
+        }
+        const int high = hexValue(path[escape + 1]);
+        const int low = hexValue(path[escape + 2]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        const char c = static_cast<char>(high << 4 | low);
+        if (c == '\0') {
+            return false;
+        }
+        if (c == '/') {
+            out.append(path.data() + escape, 3);
+        } else {
+            out.push_back(c);
+        }
+        pos = escape + 3;
+    }
+}
+
+void decodeQueryComponent(std::string_view component, std::string& out) {
+    for (std::size_t i = 0; i < component.size(); ++i) {
+        const char c = component[i];
+        if (c == '+') {
+            out.push_back(' ');
+        } else if (c == '%' && i + 2 < component.size() &&
+                   hexValue(component[i + 1]) >= 0 && hexValue(component[i + 2]) >= 0) {
+            out.push_back(static_cast<char>(hexValue(component[i + 1]) << 4 | hexValue(component[i + 2])));
+            i += 2;
+        } else {
+            out.push_back(c);
+        }
+    }
+}
+
+const std::vector<QueryParams::Param>& QueryParams::parse(std::string_view raw) {
+    if (parsed_) {
+        return params_;
+    }
+    parsed_ = true;
+
+    // Decoding only ever shrinks, so this is all the room decoded_ will need
+    decoded_.reserve(raw.size());
+
+    // Returns component as is when nothing in it needs decoding
+    const auto decode = [this](std::string_view component) -> std::string_view {
+        if (component.find_first_of("%+") == std::string_view::npos) {
+            return component;
+        }
+        const std::size_t start = decoded_.size();
+        decodeQueryComponent(component, decoded_);
+        return std::string_view(decoded_.data() + start, decoded_.size() - start);
+    };
+
+    std::size_t pos = 0;
+    while (pos <= raw.size()) {
+        std::size_t end = raw.find('&', pos);
+        if (end == std::string_view::npos) {
+            end = raw.size();
+        }
+        const std::string_view pair = raw.substr(pos, end - pos);
+        if (!pair.empty()) {
+            const std::size_t equals = pair.find('=');
+            const std::string_view key = pair.substr(0, equals);
+            const std::string_view value = equals == std::string_view::npos
+                ? std::string_view()
+                : pair.substr(equals + 1);
+            const std::string_view decodedKey = decode(key);
+            params_.emplace_back(decodedKey, decode(value));
+        }
+        pos = end + 1;
+    }
+    return params_;
+}
+
+} // namespace Http
+} // namespace Aether
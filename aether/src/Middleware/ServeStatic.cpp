@@ -1,11 +1,53 @@
 #include "Aether/Middleware/ServeStatic.h"
+#include "Aether/Http/Connection.h"
 #include <iostream> // Ensure this is included
 #include <filesystem>
 #include <algorithm>
+#include <memory>
 
 namespace Aether {
 namespace Http {
 
+namespace {
+
+#if defined(BOOST_ASIO_HAS_FILE)
+// Reads the file through the connection's io_context (io_uring) instead of
+// blocking the I/O thread, and answers through a deferred response. Returns
+// false if the file could not be opened, so the caller falls back.
+bool sendFileAsync(Response& res, const std::filesystem::path& path, const std::string& contentType) {
+    Connection* connection = Connection::of(res);
+    if (!connection) {
+        return false;
+    }
+
+    auto file = std::make_shared<boost::asio::stream_file>(connection->executor());
+    boost::system::error_code ec;
+    file->open(path.string(), boost::asio::stream_file::read_only, ec);
+    const std::uint64_t size = ec ? 0 : file->size(ec);
+    if (ec) {
+        return false;
+    }
+
+    auto content = std::make_shared<std::string>(static_cast<std::size_t>(size), '\0');
+    DeferredResponse done = res.defer();
+    boost::asio::async_read(*file, boost::asio::buffer(*content),
+        [file, content, done, contentType](const boost::system::error_code& error, std::size_t bytes) mutable {
+            if (error && error != boost::asio::error::eof) {
+                done.fail(std::make_exception_ptr(boost::system::system_error(error)));
+                return;
+            }
+            content->resize(bytes); // The file may have shrunk meanwhile
+            done.complete([content, contentType](Response& res) {
+                res.setHeader("Content-Type", contentType);
+                res.sendShared(content);
+            });
+        });
+    return true;
+}
+#endif
+
+} // anonymous namespace
+
 Middleware serveStatic(const std::string& basePath) {
     const std::filesystem::path canonicalBase = std::filesystem::weakly_canonical(basePath);
     return [canonicalBase](Request& req, Response& res, Context& context, std::function<void(std::exception_ptr)> next) {
@@ -31,6 +73,29 @@ Middleware serveStatic(const std::string& basePath) {
 
             // Check if the file exists and is a regular file
             if (std::filesystem::exists(resolved) && std::filesystem::is_regular_file(resolved)) {
+                // Set the appropriate content type
+                std::string contentType = "text/plain"; // Default content type
+                std::string extension = resolved.extension().string();
+                if (extension == ".html") {
+                    contentType = "text/html";
+                } else if (extension == ".css") {
+                    contentType = "text/css";
+                } else if (extension == ".js") {
+                    contentType = "application/javascript";
+                } else if (extension == ".json") {
+                    contentType = "application/json";
+                } else if (extension == ".png") {
+                    contentType = "image/png";
+                } else if (extension == ".jpg" || extension == ".jpeg") {
+                    contentType = "image/jpeg";
+                }
+
+#if defined(BOOST_ASIO_HAS_FILE)
+                if (sendFileAsync(res, resolved, contentType)) {
+                    return; // Answered once the read completes
+                }
+#endif
+
                 // Read the file content
                 std::ifstream file(resolved, std::ios::binary);
                 if (file) {
@@ -38,23 +103,6 @@ Middleware serveStatic(const std::string& basePath) {
                     buffer << file.rdbuf();
                     std::string fileContent = buffer.str();
 
-                    // Set the appropriate content type
-                    std::string contentType = "text/plain"; // Default content type
-                    std::string extension = resolved.extension().string();
-                    if (extension == ".html") {
-                        contentType = "text/html";
-                    } else if (extension == ".css") {
-                        contentType = "text/css";
-                    } else if (extension == ".js") {
-                        contentType = "application/javascript";
-                    } else if (extension == ".json") {
-                        contentType = "application/json";
-                    } else if (extension == ".png") {
-                        contentType = "image/png";
-                    } else if (extension == ".jpg" || extension == ".jpeg") {
-                        contentType = "image/jpeg";
-                    }
-
                     // Send the file content as the response
                     res.setHeader("Content-Type", contentType);
                     res.send(fileContent);
@@ -0,0 +1,351 @@
+// Microbenchmarks for the HTTP hot paths (see "Benchmarks" in docs/API.md).
+// Build from the repository root:
+//   g++ -std=c++17 -O2 -Iaether/include bench/bench_http.cpp $(ls aether/src/*/*.cpp | grep -v Config.cpp) -o bench_http -pthread
+// and run ./bench_http, or ./bench_http <section>... to pick sections
+// (see kSections). Numbers are the best of several rounds.
+#include "Aether/Http/ChunkedDecoder.h"
+#include "Aether/Http/HttpDate.h"
+#include "Aether/Http/HttpParser.h"
+#include "Aether/Http/Request.h"
+#include "Aether/Http/RoutePattern.h"
+#include "Aether/Http/RouteTree.h"
+#include "Aether/Http/Server.h"
+#include "Aether/Middleware/ServeStatic.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace Aether::Http;
+
+namespace {
+
+// Keeps results alive so the optimizer cannot drop the work
+volatile std::size_t sink = 0;
+
+// Nanoseconds per call of body, best of five rounds of iterations calls
+template <typename Body>
+double nsPerOp(std::size_t iterations, Body&& body) {
+    double best = 0;
+    for (int round = 0; round < 5; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            body(i);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double ns = elapsed.count() / static_cast<double>(iterations);
+        best = round == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+// A REST-style API of routeCount routes: per resource, a collection, an item
+// with a typed id, and a nested item; lookups hit every kind
+void benchRoutes() {
+    std::printf("Route lookup (ns per lookup)\n");
+    std::printf("  %8s %10s %12s\n", "routes", "tree", "linear scan");
+    for (const std::size_t routeCount : {10, 100, 400, 1000}) {
+        std::vector<RoutePattern> patterns;
+        std::vector<std::string> paths;
+        for (std::size_t i = 0; patterns.size() < routeCount; ++i) {
+            const std::string resource = "/api/v1/resource" + std::to_string(i);
+            patterns.emplace_back(resource);
+            patterns.emplace_back(resource + "/:id(int)");
+            patterns.emplace_back(resource + "/:id(int)/items/:item");
+            paths.push_back(resource);
+            paths.push_back(resource + "/42");
+            paths.push_back(resource + "/42/items/abc");
+        }
+        patterns.erase(patterns.begin() + routeCount, patterns.end());
+        paths.erase(paths.begin() + routeCount, paths.end());
+
+        RouteTree tree;
+        for (std::size_t i = 0; i < patterns.size(); ++i) {
+            tree.insert(patterns[i], i);
+        }
+
+        RouteParams params;
+        const double treeNs = nsPerOp(1000000, [&](std::size_t i) {
+            sink = sink + tree.find(paths[i % paths.size()], params);
+        });
+
+        // What routing did before the tree: try each pattern in turn
+        std::unordered_map<std::string, std::string> captured;
+        const double linearNs = nsPerOp(routeCount >= 400 ? 2000 : 20000, [&](std::size_t i) {
+            const std::string& path = paths[(i * 7919) % paths.size()];
+            for (std::size_t r = 0; r < patterns.size(); ++r) {
+                captured.clear();
+                if (patterns[r].match(path, captured)) {
+                    sink = sink + r;
+                    break;
+                }
+            }
+        });
+        std::printf("  %8zu %10.1f %12.1f\n", routeCount, treeNs, linearNs);
+    }
+}
+
+// Request heads as sent by curl and by a browser. The scanner is picked at
+// startup; build the library with -DAETHER_HTTP_NO_SIMD to time the scalar one
+void benchParser() {
+    const std::string curl =
+        "GET /api/v1/users/42 HTTP/1.1\r\n"
+        "Host: api.example.com\r\n"
+        "User-Agent: curl/8.5.0\r\n"
+        "Accept: */*\r\n"
+        "\r\n";
+    const std::string browser =
+        "GET /dashboard/reports?range=30d&team=platform HTTP/1.1\r\n"
+        "Host: app.example.com\r\n"
+        "Connection: keep-alive\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "sec-ch-ua: \"Chromium\";v=\"124\", \"Google Chrome\";v=\"124\", \"Not-A.Brand\";v=\"99\"\r\n"
+        "sec-ch-ua-mobile: ?0\r\n"
+        "sec-ch-ua-platform: \"Linux\"\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+        "Chrome/124.0.0.0 Safari/537.36\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,"
+        "image/apng,*/*;q=0.8\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Referer: https://app.example.com/dashboard\r\n"
+        "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+        "Accept-Language: en-US,en;q=0.9\r\n"
+        "Cookie: session=8f14e45fceea167a5a36dedd4bea2543; theme=dark; tz=Europe%2FBerlin\r\n"
+        "\r\n";
+
+    std::printf("Request head parsing (ns per request, %s scanner)\n", HttpParser::scannerName());
+    std::printf("  %-8s %6s %10s %8s %14s\n", "head", "bytes", "zero-copy", "owned", "in 3 reads");
+    for (const auto& [name, head] : {std::pair<const char*, const std::string&>{"curl", curl},
+                                     std::pair<const char*, const std::string&>{"browser", browser}}) {
+        RequestView view;
+        Request req;
+        std::size_t headLength = 0;
+        const double viewNs = nsPerOp(500000, [&](std::size_t) {
+            HttpParser::parseRequestHead(head, view, headLength);
+            sink = sink + headLength;
+        });
+        const double ownedNs = nsPerOp(200000, [&](std::size_t) {
+            HttpParser::parseRequestHead(head, req, headLength);
+            sink = sink + headLength;
+        });
+        // As a connection sees a head split over reads: two Incomplete calls
+        // that only search the new bytes, then the parse
+        const std::size_t third = head.size() / 3;
+        const double splitNs = nsPerOp(500000, [&](std::size_t) {
+            HttpParser::parseRequestHead(std::string_view(head).substr(0, third), view, headLength);
+            HttpParser::parseRequestHead(std::string_view(head).substr(0, 2 * third), view, headLength, third);
+            HttpParser::parseRequestHead(head, view, headLength, 2 * third);
+            sink = sink + headLength;
+        });
+        std::printf("  %-8s %6zu %10.1f %8.1f %14.1f\n", name, head.size(), viewNs, ownedNs, splitNs);
+    }
+}
+
+// A streaming logger's body: many small chunks, one log line each, decoded
+// from one buffer and from 4 KiB reads as a connection would receive it
+void benchChunked() {
+    const std::string line = "2024-05-01T12:00:00Z INFO request served in 3ms\n";
+    std::printf("Chunked body decoding\n");
+    std::printf("  %7s %6s %11s %10s %14s\n", "chunks", "size", "ns/chunk", "MB/s", "4 KiB reads");
+    for (const std::size_t chunkSize : {16, 48, 512}) {
+        const std::size_t chunkCount = 10000;
+        std::string body;
+        char sizeLine[16];
+        for (std::size_t i = 0; i < chunkCount; ++i) {
+            body.append(sizeLine, static_cast<std::size_t>(std::snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", chunkSize)));
+            for (std::size_t n = 0; n < chunkSize; n += line.size()) {
+                body.append(line, 0, std::min(line.size(), chunkSize - n));
+            }
+            body.append("\r\n");
+        }
+        body.append("0\r\n\r\n");
+
+        // Decodes body in reads of at most readSize bytes; returns the body size
+        const auto decodeAll = [&body](std::size_t readSize) {
+            ChunkedDecoder decoder;
+            std::size_t total = 0;
+            std::size_t offset = 0;
+            std::string pending; // Bytes of the last read the decoder has not used yet
+            while (offset < body.size()) {
+                const std::size_t n = std::min(readSize, body.size() - offset);
+                pending.append(body, offset, n);
+                offset += n;
+                std::string_view input(pending);
+                std::size_t consumed = 0;
+                std::string_view data;
+                ChunkedDecoder::Status status;
+                while ((status = decoder.decode(input, consumed, data)) == ChunkedDecoder::Status::Data) {
+                    total += data.size();
+                    input.remove_prefix(consumed);
+                }
+                input.remove_prefix(consumed);
+                if (status != ChunkedDecoder::Status::NeedMore) {
+                    break;
+                }
+                pending.erase(0, pending.size() - input.size());
+            }
+            return total;
+        };
+
+        const double wholeNs = nsPerOp(20, [&](std::size_t) { sink = sink + decodeAll(body.size()); });
+        const double readsNs = nsPerOp(20, [&](std::size_t) { sink = sink + decodeAll(4096); });
+        std::printf("  %7zu %6zu %11.1f %10.0f %14.1f\n", chunkCount, chunkSize, wholeNs / chunkCount,
+                    static_cast<double>(body.size()) / wholeNs * 1000.0, readsNs / chunkCount);
+    }
+}
+
+// The Date header as the connection gets it, against formatting it for every
+// response, and the precomputed status line against building one
+void benchDate() {
+    std::printf("Date header and status line (ns per response)\n");
+    char formatted[64];
+    const double cachedNs = nsPerOp(5000000, [](std::size_t) { sink = sink + httpDate().size(); });
+    const double formatNs = nsPerOp(1000000, [&](std::size_t) {
+        formatHttpDate(std::time(nullptr), formatted);
+        sink = sink + static_cast<unsigned char>(formatted[0]);
+    });
+    const double strftimeNs = nsPerOp(1000000, [&](std::size_t) {
+        const std::time_t now = std::time(nullptr);
+        std::tm tm{};
+        gmtime_r(&now, &tm);
+        sink = sink + std::strftime(formatted, sizeof(formatted), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    });
+    const double tableNs = nsPerOp(5000000, [](std::size_t i) {
+        sink = sink + HttpParser::statusLine(200 + static_cast<int>(i % 4)).size();
+    });
+    const double builtNs = nsPerOp(1000000, [](std::size_t i) {
+        const int code = 200 + static_cast<int>(i % 4);
+        const std::string line = "HTTP/1.1 " + std::to_string(code) + " " + HttpParser::statusText(code) + "\r\n";
+        sink = sink + line.size();
+    });
+    std::printf("  %-34s %8.1f\n", "httpDate(), cached per second", cachedNs);
+    std::printf("  %-34s %8.1f\n", "formatHttpDate() every response", formatNs);
+    std::printf("  %-34s %8.1f\n", "strftime() every response", strftimeNs);
+    std::printf("  %-34s %8.1f\n", "statusLine() table", tableNs);
+    std::printf("  %-34s %8.1f\n", "status line built per response", builtNs);
+}
+
+// Keep-alive clients against a running Server for a fixed time; returns
+// responses per second
+double plaintextRate(unsigned short port, const std::string& path, std::size_t clients,
+                     std::chrono::milliseconds duration) {
+    const std::string request = "GET " + path + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+    std::atomic<std::size_t> responses{0};
+    std::vector<std::thread> threads;
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    for (std::size_t c = 0; c < clients; ++c) {
+        threads.emplace_back([&] {
+            boost::asio::io_context io;
+            boost::asio::ip::tcp::socket socket(io);
+            socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+            std::string buffer;
+            std::size_t served = 0;
+            while (std::chrono::steady_clock::now() < deadline) {
+                boost::asio::write(socket, boost::asio::buffer(request));
+                const std::size_t headEnd = boost::asio::read_until(socket, boost::asio::dynamic_buffer(buffer), "\r\n\r\n");
+                const std::size_t at = buffer.find("Content-Length: ");
+                const std::size_t length = std::stoul(buffer.substr(at + 16));
+                if (buffer.size() < headEnd + length) {
+                    boost::asio::read(socket, boost::asio::dynamic_buffer(buffer),
+                                      boost::asio::transfer_exactly(headEnd + length - buffer.size()));
+                }
+                buffer.erase(0, headEnd + length);
+                ++served;
+            }
+            responses += served;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return static_cast<double>(responses) / std::chrono::duration<double>(duration).count();
+}
+
+// "Hello, World!" over loopback, with the cached Date header and with the
+// handler formatting its own Date per response, and a 16 KiB file from
+// serveStatic(). Client and server share the machine, so compare the rows
+// (or the same row across builds, e.g. epoll against -DAETHER_IO_URING)
+// rather than reading them as server capacity.
+void benchPlaintext() {
+    const auto staticDir = std::filesystem::temp_directory_path() / "aether_bench_static";
+    std::filesystem::create_directories(staticDir / "static");
+    std::ofstream(staticDir / "static" / "page.html") << std::string(16 * 1024, 'x');
+
+    Server server;
+    server.group("/static").use(serveStatic(staticDir.string())).get("/*", [](Request&, Response& res) {
+        res.sendNotFound();
+    });
+    server.get("/plaintext", [](Request&, Response& res) {
+        res.setHeader(KnownHeader::ContentType, "text/plain");
+        res.send("Hello, World!");
+    });
+    server.get("/plaintext-formatted-date", [](Request&, Response& res) {
+        const std::time_t now = std::time(nullptr);
+        std::tm tm{};
+        gmtime_r(&now, &tm);
+        char date[64];
+        std::strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        res.setHeader(KnownHeader::Date, date);
+        res.setHeader(KnownHeader::ContentType, "text/plain");
+        res.send("Hello, World!");
+    });
+
+    unsigned short port = 0;
+    {
+        boost::asio::io_context io;
+        boost::asio::ip::tcp::acceptor probe(io, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+        port = probe.local_endpoint().port();
+    }
+    std::thread running([&server, port] { server.run(port); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200)); // Until it listens
+
+    std::printf("Plaintext over loopback (responses per second, 4 keep-alive clients, %s)\n",
+                Aether::EventLoop::ioBackend());
+    for (const char* path : {"/plaintext", "/plaintext-formatted-date", "/static/page.html"}) {
+        plaintextRate(port, path, 4, std::chrono::milliseconds(300)); // Warm-up
+        std::printf("  %-28s %10.0f\n", path, plaintextRate(port, path, 4, std::chrono::seconds(3)));
+    }
+    server.stop();
+    running.join();
+    std::filesystem::remove_all(staticDir);
+}
+
+struct Section {
+    const char* name;
+    void (*run)();
+};
+
+constexpr Section kSections[] = {
+    {"parser", benchParser},
+    {"chunked", benchChunked},
+    {"routes", benchRoutes},
+    {"date", benchDate},
+    {"plaintext", benchPlaintext},
+};
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    for (const Section& section : kSections) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || std::strcmp(argv[i], section.name) == 0;
+        }
+        if (selected) {
+            section.run();
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
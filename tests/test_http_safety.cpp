@@ -2,12 +2,181 @@
 #include "Aether/Http/Request.h"
 #include "Aether/Middleware/ServeStatic.h"
 #include "Aether/Http/HttpParser.h"
+#include "Aether/Http/Connection.h"
+#include "Aether/Http/RouteTree.h"
+#include "Aether/Http/RouteConstraint.h"
+#include "Aether/Http/HttpDate.h"
+#include "Aether/Http/Route.h"
+#include "Aether/Http/Server.h"
+#include "Aether/Http/RouteTemplate.h"
+#include "Aether/Http/BodyFile.h"
+#include "Aether/Http/Multipart.h"
+#include "Aether/Http/ChunkedDecoder.h"
+#include "Aether/Http/TimerWheel.h"
+#include "Aether/Http/Awaitable.h"
+#include "Aether/Core/BlockingExecutor.h"
+#include <sys/socket.h>
+#include <sys/time.h>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <cassert>
+#include <mutex>
+#include <set>
+#include <thread>
 
 using namespace Aether::Http;
 
+static constexpr char kTypedRoute[] = "/users/:id(int)/posts/:slug";
+
+// A Connection on the server end of a loopback socket, with every request
+// routed to one Route. Its io_context runs on `threads` threads and the
+// socket is on a strand. One thread gets a timer wheel, like a shard; more
+// get a timer per connection. The test drives the client end with blocking
+// reads and writes.
+class Loopback {
+public:
+    explicit Loopback(Route route, std::size_t threads = 1, ConnectionOptions options = {},
+                      MiddlewareStack middleware = {})
+        : route_(std::move(route)), middleware_(std::move(middleware)), client_(io_) {
+        boost::asio::ip::tcp::acceptor acceptor(
+            io_, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+        client_.connect(acceptor.local_endpoint());
+        boost::asio::ip::tcp::socket server =
+            acceptor.accept(boost::asio::any_io_executor(boost::asio::make_strand(io_)));
+        timeval timeout{5, 0}; // A hung server fails the test instead of stalling it
+        setsockopt(client_.native_handle(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        auto connection = std::make_shared<Connection>(
+            std::move(server),
+            [this](Method, std::string_view, Request&, RoutePin&) { return &route_; },
+            middleware_,
+            [] {},
+            threads == 1 ? &boost::asio::use_service<TimerService>(io_) : nullptr,
+            options);
+        connection_ = connection;
+        connection->start();
+        for (std::size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this] { io_.run(); });
+        }
+    }
+
+    ~Loopback() {
+        // The connection goes away once it has seen the client close
+        boost::system::error_code ec;
+        client_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        client_.close(ec);
+        for (int i = 0; i < 500 && !connection_.expired(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        work_.reset();
+        io_.stop();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    boost::asio::ip::tcp::socket& client() { return client_; }
+
+    void send(std::string_view data) {
+        boost::asio::write(client_, boost::asio::buffer(data.data(), data.size()));
+    }
+
+    // Everything up to and including marker; empty if the connection ended first
+    std::string readUntil(std::string_view marker) {
+        std::size_t at;
+        std::size_t from = 0;
+        while ((at = buffer_.find(marker, from)) == std::string::npos) {
+            from = buffer_.size() < marker.size() ? 0 : buffer_.size() - marker.size() + 1;
+            if (!fill()) {
+                return {};
+            }
+        }
+        std::string out = buffer_.substr(0, at + marker.size());
+        buffer_.erase(0, at + marker.size());
+        return out;
+    }
+
+    std::string readExactly(std::size_t bytes) {
+        while (buffer_.size() < bytes && fill()) {
+        }
+        std::string out = buffer_.substr(0, bytes);
+        buffer_.erase(0, out.size());
+        return out;
+    }
+
+    // A Content-Length response, head and body
+    std::string readResponse() {
+        std::string head = readUntil("\r\n\r\n");
+        const std::size_t at = head.find("Content-Length: ");
+        if (at == std::string::npos) {
+            return head;
+        }
+        return head + readExactly(std::stoul(head.substr(at + 16)));
+    }
+
+    // Whatever arrives until the server closes the connection
+    std::string readToEnd() {
+        while (fill()) {
+        }
+        return std::exchange(buffer_, {});
+    }
+
+    bool closedByServer() {
+        return buffer_.empty() && !fill();
+    }
+
+private:
+    bool fill() {
+        char data[4096];
+        boost::system::error_code ec;
+        const std::size_t bytes = client_.read_some(boost::asio::buffer(data), ec);
+        buffer_.append(data, bytes);
+        return !ec;
+    }
+
+    boost::asio::io_context io_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_{io_.get_executor()};
+    Route route_;
+    MiddlewareStack middleware_;
+    boost::asio::ip::tcp::socket client_;
+    std::weak_ptr<Connection> connection_;
+    std::vector<std::thread> threads_;
+    std::string buffer_;
+};
+
+// A port that was free a moment ago, for a Server under test
+static unsigned short freePort() {
+    boost::asio::io_context io;
+    boost::asio::ip::tcp::acceptor acceptor(
+        io, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    return acceptor.local_endpoint().port();
+}
+
+// One GET over a fresh connection that the server closes after answering;
+// retried while the server is still starting. Returns the response body.
+static std::string fetch(unsigned short port, const std::string& path) {
+    boost::asio::io_context io;
+    boost::asio::ip::tcp::socket socket(io);
+    const boost::asio::ip::tcp::endpoint server(boost::asio::ip::address_v4::loopback(), port);
+    boost::system::error_code ec;
+    for (int attempt = 0; attempt < 500; ++attempt) {
+        socket.connect(server, ec);
+        if (!ec) {
+            break;
+        }
+        socket.close();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(!ec);
+    const std::string request = "GET " + path + " HTTP/1.1\r\nHost: a\r\nConnection: close\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(request));
+    std::string response;
+    boost::asio::read(socket, boost::asio::dynamic_buffer(response), ec);
+    const std::size_t bodyAt = response.find("\r\n\r\n");
+    return bodyAt == std::string::npos ? std::string() : response.substr(bodyAt + 4);
+}
+
 int main() {
     // Prepare a temporary directory for static files and templates
     const auto tempDir = std::filesystem::temp_directory_path() / "aether_http_safety";
@@ -83,11 +252,1096 @@ int main() {
         assert(Connection::wantsKeepAlive(req) == false);
     }
 
+    // Incremental head parsing resumes across partial reads and rejects junk
+    {
+        const std::string raw =
+            "POST /upload HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "X-Long-Header-Name-Spanning-Simd-Lanes:   padded value\t \r\n"
+            "\r\n"
+            "body";
+        Request req;
+        std::size_t headLength = 0;
+        std::size_t searchedLength = 0;
+        for (std::size_t n = 1; n < raw.size() - 4; ++n) {
+            auto result = HttpParser::parseRequestHead(std::string_view(raw.data(), n), req, headLength, searchedLength);
+            assert(result == HttpParser::ParseResult::Incomplete);
+            searchedLength = n;
+        }
+        assert(HttpParser::parseRequestHead(raw, req, headLength, searchedLength) == HttpParser::ParseResult::Complete);
+        assert(headLength == raw.size() - 4);
+        assert(req.method == "POST" && req.path == "/upload" && req.version == "HTTP/1.1");
+        assert(req.headers.at("x-long-header-name-spanning-simd-lanes") == "padded value");
+
+        // The blank line is found by the vector search at every offset, split
+        // across reads or not
+        for (std::size_t padding = 0; padding < 80; ++padding) {
+            const std::string head = "GET / HTTP/1.1\r\nX: " + std::string(padding, 'a') + "\r\n\r\n";
+            for (const std::size_t searched : {std::size_t{1}, head.size() - 3, head.size() - 1}) {
+                assert(HttpParser::parseRequestHead(std::string_view(head).substr(0, head.size() - 1), req.view,
+                                                    headLength, searched) == HttpParser::ParseResult::Incomplete);
+                assert(HttpParser::parseRequestHead(head + "GET / HTTP/1.1\r\n\r\n", req.view, headLength,
+                                                    searched) == HttpParser::ParseResult::Complete);
+                assert(headLength == head.size());
+            }
+        }
+
+        // Pipelined requests: each parse stops at the end of its own head
+        const std::string pipelined =
+            "GET /a HTTP/1.1\r\nHost: x\r\n\r\n"
+            "GET /b HTTP/1.1\r\nHost: x\r\n\r\n";
+        assert(HttpParser::parseRequestHead(pipelined, req.view, headLength) == HttpParser::ParseResult::Complete);
+        assert(req.view.path == "/a" && headLength == pipelined.size() / 2);
+        assert(HttpParser::parseRequestHead(std::string_view(pipelined).substr(headLength), req.view, headLength) ==
+               HttpParser::ParseResult::Complete);
+        assert(req.view.path == "/b");
+
+        assert(!HttpParser::parseRequest(std::string("GET / HTTP/2.0\r\n\r\n"), req));
+        assert(!HttpParser::parseRequest(std::string("BREW / HTTP/1.1\r\n\r\n"), req));
+        assert(!HttpParser::parseRequest(std::string("GET / HTTP/1.1\r\nNo colon here\r\n\r\n"), req));
+        assert(!HttpParser::parseRequest(std::string("GET / HTTP/1.1\r\nBad\x01: x\r\n\r\n"), req));
+        assert(!HttpParser::parseRequest(std::string("GET /a b HTTP/1.1\r\n\r\n"), req));
+    }
+
+    // Methods are mapped to an enum once, by the parser
+    {
+        for (std::size_t i = 0; i < kMethodCount; ++i) {
+            const auto method = static_cast<Method>(i);
+            assert(lookupMethod(methodName(method)) == method);
+            Request req;
+            const std::string raw = std::string(methodName(method)) + " /x HTTP/1.1\r\nHost: x\r\n\r\n";
+            assert(HttpParser::parseRequest(raw, req));
+            assert(req.view.methodId == method && req.method == methodName(method));
+        }
+        static_assert(lookupMethod("PATCH") == Method::Patch);
+        assert(lookupMethod("get") == Method::Count && lookupMethod("TRACE") == Method::Count);
+
+        Request req;
+        assert(!HttpParser::parseRequest(std::string("patch / HTTP/1.1\r\n\r\n"), req));
+        req.clear();
+        assert(req.view.methodId == Method::Count);
+    }
+
+    // Zero-copy parsing fills only the view, which materialize() copies out
+    {
+        const std::string raw =
+            "GET /users/42 HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "X-Trace-Id: abc\r\n"
+            "\r\n";
+        Request req;
+        req.zeroCopy(true);
+        std::size_t headLength = 0;
+        assert(HttpParser::parseRequestHead(raw, req.view, headLength) == HttpParser::ParseResult::Complete);
+        assert(req.method.empty() && req.headers.empty());
+        assert(req.view.method == "GET" && req.view.path == "/users/42");
+        assert(req.view.path.data() == raw.data() + 4);
+        assert(req.view.header("x-trace-id") == "abc");
+        assert(req.header("HOST") == "example.com");
+
+        // A copy owns its data and outlives the buffer
+        std::string buffer = raw;
+        Request zeroCopy;
+        zeroCopy.zeroCopy(true);
+        assert(HttpParser::parseRequestHead(buffer, zeroCopy.view, headLength) == HttpParser::ParseResult::Complete);
+        const Request copy = zeroCopy;
+        buffer.assign(buffer.size(), 'x');
+        assert(!copy.zeroCopy() && copy.view.method.empty());
+        assert(copy.path == "/users/42" && copy.header("x-trace-id") == "abc");
+
+        req.materialize();
+        assert(req.path == "/users/42");
+        assert(req.headers.at("x-trace-id") == "abc");
+    }
+
+    // Owned requests answer from the owned fields, so middleware edits show
+    {
+        Request req;
+        assert(HttpParser::parseRequest(std::string("GET /?a=1 HTTP/1.1\r\nHost: a.com\r\nX-Tag: one\r\n\r\n"), req));
+        assert(!req.zeroCopy() && req.header("x-tag") == "one");
+        assert(req.header("X-Tag") == "one" && req.hasHeader("HOST") && !req.hasHeader("X-Other"));
+        req.headers["x-tag"] = "two";
+        req.headers.erase("host");
+        req.headers["host"] = "b.com";
+        req.queryString = "a=2";
+        assert(req.header("x-tag") == "two" && req.header(KnownHeader::Host) == "b.com");
+        assert(req.getDomain() == "b.com" && req.query("a") == "2");
+
+        const Request copy = req;
+        assert(copy.view.method.empty() && copy.header("x-tag") == "two");
+    }
+
+    // The target is split at '?'; paths are decoded and queries parsed lazily
+    {
+        const std::string raw =
+            "GET /caf%C3%A9/a%2Fb?limit=25&q=red+shoes%21&flag&limit=99 HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "\r\n";
+        Request viewOnly;
+        viewOnly.zeroCopy(true);
+        std::size_t headLength = 0;
+        assert(HttpParser::parseRequestHead(raw, viewOnly.view, headLength) == HttpParser::ParseResult::Complete);
+        assert(viewOnly.view.path == "/caf%C3%A9/a%2Fb");
+        assert(viewOnly.view.query == "limit=25&q=red+shoes%21&flag&limit=99");
+        assert(viewOnly.query<int>("limit") == 25);
+        assert(viewOnly.query("q") == "red shoes!");
+        assert(viewOnly.hasQuery("flag") && viewOnly.query("flag").empty());
+        assert(!viewOnly.query<int>("q") && !viewOnly.query<int>("missing"));
+        assert(viewOnly.queryParams().size() == 4);
+
+        Request owned;
+        assert(HttpParser::parseRequestHead(raw, owned, headLength) == HttpParser::ParseResult::Complete);
+        assert(owned.path == "/caf\xC3\xA9/a%2Fb"); // Encoded slashes stay encoded
+        assert(owned.queryString == viewOnly.view.query);
+        assert(owned.getUrl() == owned.path + "?" + owned.queryString);
+
+        Request copy = viewOnly; // Starts unparsed, so nothing points into viewOnly
+        viewOnly.clear();
+        assert(copy.query<double>("limit") == 25.0);
+
+        std::string decoded;
+        assert(decodePath("/a%20b", decoded) && decoded == "/a b");
+        assert(!decodePath("/bad%zz", decoded) && !decodePath("/nul%00", decoded) && !decodePath("/cut%4", decoded));
+        assert(HttpParser::parseRequestHead("GET /x%zz HTTP/1.1\r\nHost: a\r\n\r\n", owned, headLength) ==
+               HttpParser::ParseResult::Invalid);
+        assert(parseNumber<long>("+42") == 42L && !parseNumber<int>("42abc") && !parseNumber<int>(""));
+    }
+
+    // Well-known headers use fixed slots on both Request and Response
+    {
+        assert(lookupKnownHeader("content-LENGTH") == KnownHeader::ContentLength);
+        assert(lookupKnownHeader("X-Content-Length") == KnownHeader::Count);
+        assert(knownHeaderName(KnownHeader::ETag) == "ETag");
+
+        const std::string raw =
+            "POST /upload HTTP/1.1\r\n"
+            "host: example.com\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n";
+        RequestView view;
+        std::size_t headLength = 0;
+        assert(HttpParser::parseRequestHead(raw, view, headLength) == HttpParser::ParseResult::Complete);
+        assert(view.header(KnownHeader::Host) == "example.com");
+        assert(view.hasHeader(KnownHeader::ContentLength) && view.header(KnownHeader::ContentLength) == "0");
+        assert(!view.hasHeader(KnownHeader::Expect));
+        assert(view.headers.empty());
+
+        const std::string duplicateHost =
+            "GET / HTTP/1.1\r\nHost: a\r\nHost: b\r\n\r\n";
+        assert(HttpParser::parseRequestHead(duplicateHost, view, headLength) == HttpParser::ParseResult::Invalid);
+        const std::string duplicateCoding =
+            "POST / HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n\r\n";
+        assert(HttpParser::parseRequestHead(duplicateCoding, view, headLength) == HttpParser::ParseResult::Invalid);
+
+        Response res;
+        res.setHeader("content-type", "text/plain");
+        res.setHeader("X-Custom", "1");
+        assert(res.getHeader(KnownHeader::ContentType) == "text/plain");
+        assert(res.headers.size() == 1 && res.headers.count("X-Custom") == 1);
+        res.removeHeader(KnownHeader::ContentType);
+        assert(!res.hasHeader(KnownHeader::ContentType));
+    }
+
+    // Shared response bodies, precomputed status lines and the Date cache
+    {
+        auto page = std::make_shared<const std::string>("cached page");
+        Response res;
+        res.send("owned");
+        res.sendShared(page, 201);
+        assert(res.bodyView() == "cached page" && res.bodyView().data() == page->data());
+        assert(res.body.empty() && res.statusCode == 201);
+        res.send("owned");
+        assert(!res.sharedBody && res.bodyView() == "owned");
+
+        // Without a connection, streamed writes simply accumulate in body
+        Response detached;
+        assert(detached.write("ab") && detached.write("cd"));
+        detached.end();
+        assert(detached.body == "abcd");
+
+        assert(HttpParser::statusLine(404) == "HTTP/1.1 404 Not Found\r\n");
+        assert(HttpParser::statusLine(42) == HttpParser::statusLine(500));
+        assert(HttpParser::statusLine(599) == "HTTP/1.1 599 Unknown\r\n");
+        assert(HttpParser::statusText(429) == "Too Many Requests");
+
+        char date[29];
+        formatHttpDate(784111777, date);
+        assert(std::string_view(date, sizeof(date)) == "Sun, 06 Nov 1994 08:49:37 GMT");
+        assert(httpDate().size() == 29 && httpDate().substr(25) == " GMT");
+    }
+
     // Body limit guard rails
     {
         assert(Connection::exceedsBodyLimit(0, Connection::kMaxBodySizeBytes - 1) == false);
         assert(Connection::exceedsBodyLimit(Connection::kMaxBodySizeBytes, 1) == true);
         assert(Connection::exceedsBodyLimit(1024, Connection::kMaxBodySizeBytes) == true);
+        assert(Connection::exceedsBodyLimit(0, 11, 10) == true);
+        assert(Connection::exceedsBodyLimit(5, 5, 10) == false);
+
+        const RouteOptions options = RouteOptions().streaming().bodyLimit(8ull << 30);
+        assert(options.streamBody && options.maxBodyBytes == (8ull << 30));
+    }
+
+    // Spilled bodies: appended to an unlinked file and read back through a mapping
+    {
+        BodyFile empty(tempDir.string());
+        empty.seal();
+        assert(empty.size() == 0);
+
+        BodyFile file(tempDir.string());
+        const std::string block(5000, 'x');
+        file.append(block);
+        file.append("tail");
+        file.seal();
+        assert(file.size() == 5004);
+        const std::string_view data = file.data();
+        assert(data.substr(0, 5000) == block && data.substr(5000) == "tail");
+    }
+
+    // Multipart parser: same parts however the body is split
+    {
+        const std::string boundary = MultipartParser::boundaryFrom("multipart/form-data; boundary=\"x-42\"");
+        assert(boundary == "x-42");
+        assert(MultipartParser::boundaryFrom("text/plain; boundary=x-42").empty());
+
+        const std::string body =
+            "--x-42\r\nContent-Disposition: form-data; name=\"title\"\r\n\r\nhello\r\n"
+            "--x-42\r\nContent-Disposition: form-data; name=\"doc\"; filename=\"a.txt\"\r\n"
+            "Content-Type: text/plain\r\n\r\nline\r\n--x-4 is not a boundary\r\n"
+            "--x-42--\r\n";
+        for (std::size_t split = 0; split <= body.size(); ++split) {
+            MultipartParser parser(boundary);
+            std::vector<MultipartPart> parts;
+            parser.onPartData([](MultipartPart& part, std::string_view data) { part.data.append(data); });
+            parser.onPartEnd([&parts](MultipartPart& part) { parts.push_back(std::move(part)); });
+            assert(parser.feed(std::string_view(body).substr(0, split)));
+            assert(parser.feed(std::string_view(body).substr(split)));
+            assert(parser.done() && parts.size() == 2);
+            assert(parts[0].name == "title" && parts[0].data == "hello" && parts[0].filename.empty());
+            assert(parts[1].filename == "a.txt" && parts[1].contentType == "text/plain");
+            assert(parts[1].data == "line\r\n--x-4 is not a boundary");
+        }
+
+        MultipartParser bad(boundary);
+        assert(!bad.feed("--x-42garbage\r\n") && !bad.error().empty());
+    }
+
+    // Chunked decoder: resumes anywhere, skips extensions and trailers
+    {
+        const std::string wire =
+            "3;name=\"a;b\"\r\nabc\r\n10 ; ext\r\n0123456789abcdef\r\n"
+            "0\r\nX-Checksum: 1\r\n\r\nGET /next";
+        const std::size_t bodyEnd = wire.size() - 9;
+        for (std::size_t split = 0; split <= bodyEnd; ++split) {
+            ChunkedDecoder decoder;
+            std::string body;
+            std::size_t offset = 0;
+            std::string_view input(wire.data(), split);
+            ChunkedDecoder::Status status;
+            for (;;) {
+                std::size_t consumed = 0;
+                std::string_view data;
+                status = decoder.decode(input.substr(offset), consumed, data);
+                offset += consumed;
+                if (status == ChunkedDecoder::Status::Data) {
+                    body.append(data);
+                } else if (status == ChunkedDecoder::Status::NeedMore && input.size() < wire.size()) {
+                    assert(offset == input.size());
+                    input = wire;
+                } else {
+                    break;
+                }
+            }
+            assert(status == ChunkedDecoder::Status::Done);
+            assert(body == "abc0123456789abcdef" && decoder.bodyBytes() == 19);
+            assert(offset == bodyEnd); // Stops before the next request
+        }
+
+        const auto decodeAll = [](std::string_view wire, std::size_t limit) {
+            ChunkedDecoder decoder(limit);
+            std::size_t consumed = 0;
+            std::string_view data;
+            auto status = decoder.decode(wire, consumed, data);
+            while (status == ChunkedDecoder::Status::Data) {
+                wire.remove_prefix(consumed);
+                status = decoder.decode(wire, consumed, data);
+            }
+            return status;
+        };
+        assert(decodeAll("3\nabc\r\n0\r\n\r\n", 100) == ChunkedDecoder::Status::Invalid);
+        assert(decodeAll("3\r\nabcX\r\n", 100) == ChunkedDecoder::Status::Invalid);
+        assert(decodeAll(";x\r\n", 100) == ChunkedDecoder::Status::Invalid);
+        assert(decodeAll("5\r\nabcde\r\n6\r\n", 10) == ChunkedDecoder::Status::TooLarge);
+        assert(decodeAll("fffffffffffffffff\r\n", 100) == ChunkedDecoder::Status::TooLarge);
+        assert(decodeAll("5\r\nab", 100) == ChunkedDecoder::Status::NeedMore);
+    }
+
+    // Route templates are checked at compile time and bind typed handlers
+    {
+        static_assert(parseRouteTemplate("/users/:id(int)/posts/:slug").paramCount == 2);
+        static_assert(parseRouteTemplate("/users/:id(int)").types[0] == ParamType::Int);
+        static_assert(parseRouteTemplate("users").error == RouteTemplateInfo::NoLeadingSlash);
+        static_assert(parseRouteTemplate("/a/:id(float)").error == RouteTemplateInfo::UnknownType);
+        static_assert(parseRouteTemplate("/a/:id/:id").error == RouteTemplateInfo::DuplicateParam);
+        static_assert(parseRouteTemplate("/a/*rest/b").error == RouteTemplateInfo::WildcardNotLast);
+        static_assert(parseRouteTemplate("/a?b").error == RouteTemplateInfo::ReservedChar);
+
+        RouteTree tree;
+        tree.insert(RoutePattern(kTypedRoute), 0);
+        const RequestHandler handler = RouteTemplate<kTypedRoute>::bind(
+            [](Request&, Response& res, std::int64_t id, std::string_view slug) {
+                res.send(std::to_string(id + 1) + "/" + std::string(slug));
+            });
+
+        Request req;
+        Response res;
+        assert(tree.find("/users/41/posts/hello", req.view.params) == 0);
+        handler(req, res);
+        assert(res.statusCode == 200 && res.body == "42/hello");
+
+        assert(tree.find("/users/abc/posts/hello", req.view.params) == RouteTree::npos);
+
+        // Bound to a pattern without the constraint, a bad value is still a 404
+        RouteTree loose;
+        loose.insert(RoutePattern("/users/:id/posts/:slug"), 0);
+        Response notFound;
+        assert(loose.find("/users/abc/posts/hello", req.view.params) == 0);
+        handler(req, notFound);
+        Response unmatched;
+        unmatched.sendNotFound();
+        assert(notFound.statusCode == 404 && notFound.body == unmatched.body);
+        assert(notFound.getHeader(KnownHeader::ContentType) == "text/html");
+    }
+
+    // Constraints: built-in scanners, regexes compiled to a DFA, and routing
+    {
+        const auto constraint = [](const char* text) { return RouteConstraint::parse(text); };
+        assert(constraint("int")->matches("-42") && !constraint("int")->matches("4x"));
+        assert(!constraint("int")->matches("99999999999999999999") && !constraint("int")->matches(""));
+        assert(constraint("uint")->matches("18446744073709551615") && !constraint("uint")->matches("-1"));
+        assert(constraint("uuid")->matches("123e4567-e89b-12d3-a456-426614174000"));
+        assert(!constraint("uuid")->matches("123e4567e89b-12d3-a456-426614174000-"));
+        assert(constraint("hex")->matches("DeadBeef") && !constraint("hex")->matches("0xff"));
+        assert(constraint("slug")->matches("my-post_2") && !constraint("slug")->matches("a.b"));
+        assert(constraint("alpha")->matches("abcXYZ") && !constraint("alpha")->matches("abc1"));
+        assert(constraint("int")->kind() == RouteConstraint::Kind::Int);
+
+        const auto digits = constraint("\\d+");
+        assert(digits->kind() == RouteConstraint::Kind::Regex);
+        assert(digits->matches("2024") && !digits->matches("") && !digits->matches("12a"));
+        const auto file = constraint("[a-z0-9_-]+\\.(txt|md)");
+        assert(file->matches("read_me.md") && file->matches("a-1.txt"));
+        assert(!file->matches("notes.txt.bak") && !file->matches("Notes.txt"));
+        const auto version = constraint("^v\\d{1,3}(\\.\\d{1,3}){0,2}$");
+        assert(version->matches("v1") && version->matches("v10.2.33"));
+        assert(!version->matches("v1.2.3.4") && !version->matches("v1234"));
+        assert(constraint("[^.]*")->matches("") && !constraint("[^.]*")->matches("a.b"));
+        assert(constraint("(?:ab|a)*c")->matches("abaabc"));
+
+        for (const char* bad : {"(a", "a)", "[a-", "a{2", "*a", "a*?", "(?=a)", "\\1", "a{1000}", "a^"}) {
+            bool threw = false;
+            try {
+                RoutePattern pattern(std::string("/x/:p(") + bad + ")");
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+        }
+
+        RouteTree tree;
+        tree.insert(RoutePattern("/items/:name"), 0);
+        tree.insert(RoutePattern("/items/:id(int)"), 1);
+        tree.insert(RoutePattern("/items/:key(uuid)"), 2);
+        tree.insert(RoutePattern("/items/new"), 3);
+        tree.insert(RoutePattern("/items/:id(int)/parts/:part([a-z]{2}\\d)"), 4);
+        assert(tree.insert(RoutePattern("/items/:n(int)"), 5) == 1);
+
+        RouteParams params;
+        assert(tree.find("/items/42", params) == 1 && params.get("id") == "42");
+        assert(tree.find("/items/widget", params) == 0 && params.get("name") == "widget");
+        assert(tree.find("/items/123e4567-e89b-12d3-a456-426614174000", params) == 2);
+        assert(tree.find("/items/new", params) == 3);
+        assert(tree.find("/items/7/parts/ab1", params) == 4 && params.get("part") == "ab1");
+        assert(tree.find("/items/7/parts/abc", params) == RouteTree::npos);
+
+        // RoutePattern::match applies the constraint too
+        std::unordered_map<std::string, std::string> matched;
+        assert(RoutePattern("/items/:id(int)").match("/items/7", matched) && matched["id"] == "7");
+        assert(!RoutePattern("/items/:id(int)").match("/items/seven", matched));
+    }
+
+    // Route groups: normalized, nestable prefixes; scoped middleware can stop the chain
+    {
+        Server server;
+        RouteGroup api = server.group("api/v1/");
+        assert(api.prefix() == "/api/v1");
+        assert(api.group("admin//").prefix() == "/api/v1/admin");
+        assert(server.group("/").prefix().empty());
+
+        int calls = 0;
+        RouteOptions options;
+        options.use([&](Request&, Response&, Context&, std::function<void(std::exception_ptr)> next) {
+                   ++calls;
+                   next(nullptr);
+               })
+               .use([](Request&, Response& res, Context&, std::function<void(std::exception_ptr)>) {
+                   res.send("denied", 401);
+               });
+        assert(options.middleware.size() == 2);
+
+        MiddlewareStack stack;
+        for (const auto& m : options.middleware) {
+            stack.use(m);
+        }
+        Request req;
+        Response res;
+        bool reached = false;
+        stack.run(req, res, [&] { reached = true; });
+        assert(calls == 1 && !reached && res.statusCode == 401);
+    }
+
+    // Virtual hosts: names are normalized, nested groups keep the host
+    {
+        Server server;
+        assert(server.vhost("API.Example.com:8080").host() == "api.example.com");
+        assert(server.vhost("*.example.com.").group("/v1").host() == "*.example.com");
+        assert(server.vhost("[::1]:80").host() == "[::1]");
+        assert(server.group("/api").host().empty());
+        for (const char* bad : {"", ":80", "*", "*.", "a.*.com", "ex*ample.com"}) {
+            bool threw = false;
+            try {
+                server.vhost(bad);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+        }
+    }
+
+    // Route tree: static > param > wildcard, with backtracking
+    {
+        RouteTree tree;
+        tree.insert(RoutePattern("/"), 0);
+        tree.insert(RoutePattern("/users/:id"), 1);
+        tree.insert(RoutePattern("/users/me"), 2);
+        tree.insert(RoutePattern("/users/:id/posts/:slug"), 3);
+        tree.insert(RoutePattern("/users/me/settings"), 4);
+        tree.insert(RoutePattern("/static/*path"), 5);
+        tree.insert(RoutePattern("/api/v1/status"), 6);
+        tree.insert(RoutePattern("/api/v2/status"), 7);
+        assert(tree.insert(RoutePattern("/users/:name"), 8) == 1);
+
+        RouteParams params;
+        assert(tree.find("/", params) == 0);
+        assert(tree.find("/users/42", params) == 1);
+        assert(params.get("id") == "42");
+        assert(tree.find("/users/me", params) == 2);
+        assert(params.empty());
+        assert(tree.find("/users/me/posts/hello", params) == 3);
+        assert(params.get("id") == "me" && params.get("slug") == "hello");
+        assert(tree.find("//users/me/settings/", params) == 4);
+        assert(tree.find("/static/css/site.css", params) == 5);
+        assert(params.get("path") == "css/site.css");
+        assert(tree.find("/static", params) == 5);
+        assert(params.get("path").empty());
+        assert(tree.find("/api/v1/status", params) == 6);
+        assert(tree.find("/api/v2/status", params) == 7);
+        assert(tree.find("/api/v3/status", params) == RouteTree::npos);
+        assert(tree.find("/users", params) == RouteTree::npos);
+    }
+
+    // Sharded server: connections are accepted and served on both shards
+    {
+        std::mutex threadsMutex;
+        std::set<std::thread::id> servedOn;
+        Server server;
+        server.sharded(2);
+        server.get("/", [&](Request&, Response& res) {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            servedOn.insert(std::this_thread::get_id());
+            res.send("sharded");
+        });
+        const unsigned short port = freePort();
+        std::thread running([&server, port] { server.run(port); });
+        for (int i = 0; i < 32; ++i) {
+            assert(fetch(port, "/") == "sharded");
+        }
+        server.stop();
+        running.join();
+        assert(servedOn.size() == 2);
+    }
+
+    // Routes registered while the server runs are visible at once to other
+    // threads and to kept-alive connections, and a replaced route is freed
+    // once nothing pins its table. Each thread caches the table it last used
+    // until its next lookup, so that is only deterministic with one worker.
+    for (const std::size_t shards : {0, 1}) {
+        Server server;
+        if (shards > 0) {
+            server.sharded(shards);
+        }
+        server.get("/base", [](Request&, Response& res) { res.send("base"); });
+        auto token = std::make_shared<int>(0);
+        std::weak_ptr<int> firstVersion = token;
+        server.get("/version", [token](Request&, Response& res) { res.send("v0"); });
+        token.reset();
+        const unsigned short port = freePort();
+        std::thread running([&server, port] { server.run(port); });
+        assert(fetch(port, "/base") == "base");
+
+        boost::asio::io_context io;
+        boost::asio::ip::tcp::socket kept(io);
+        kept.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+        const auto keptFetch = [&kept](const std::string& path) {
+            const std::string request = "GET " + path + " HTTP/1.1\r\nHost: a\r\n\r\n";
+            boost::asio::write(kept, boost::asio::buffer(request));
+            std::string response;
+            const std::size_t headEnd = boost::asio::read_until(kept, boost::asio::dynamic_buffer(response), "\r\n\r\n");
+            const std::size_t at = response.find("Content-Length: ");
+            const std::size_t length = std::stoul(response.substr(at + 16));
+            if (response.size() < headEnd + length) {
+                boost::asio::read(kept, boost::asio::dynamic_buffer(response),
+                                  boost::asio::transfer_exactly(headEnd + length - response.size()));
+            }
+            return response.substr(headEnd, length);
+        };
+        assert(keptFetch("/version") == "v0");
+
+        std::atomic<bool> done{false};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 3; ++i) {
+            readers.emplace_back([&done, port] {
+                while (!done) {
+                    assert(fetch(port, "/base") == "base");
+                }
+            });
+        }
+        for (int i = 1; i <= 30; ++i) {
+            const std::string body = "v" + std::to_string(i);
+            server.get("/version", [body](Request&, Response& res) { res.send(body); });
+            server.get("/r/" + std::to_string(i), [body](Request&, Response& res) { res.send(body); });
+            assert(fetch(port, "/version") == body);
+            assert(fetch(port, "/r/" + std::to_string(i)) == body);
+            assert(keptFetch("/version") == body);
+        }
+        done = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        kept.close();
+        if (shards == 1) {
+            assert(fetch(port, "/base") == "base"); // The worker's last lookup is on the newest table
+            for (int i = 0; i < 100 && !firstVersion.expired(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Closed connections let go
+            }
+            assert(firstVersion.expired());
+        }
+        server.stop();
+        running.join();
+    }
+
+    // Streamed routes run the server-wide and route middleware on the head,
+    // before any body is read; middleware that answers leaves it unread
+    {
+        MiddlewareStack stack;
+        stack.use([](Request& req, Response& res, Context&, std::function<void(std::exception_ptr)> next) {
+            if (req.header("authorization") != "yes") {
+                res.send("denied", 401);
+                return;
+            }
+            res.setHeader("X-Server", "1");
+            next(nullptr);
+        });
+        auto routeMiddleware = std::make_shared<MiddlewareStack>();
+        routeMiddleware->use([](Request&, Response& res, Context&, std::function<void(std::exception_ptr)> next) {
+            res.setHeader("X-Route", "1");
+            next(nullptr);
+        });
+        Route route;
+        route.options.streamBody = true;
+        route.middleware = routeMiddleware;
+        route.handler = [](Request& req, Response& res) {
+            auto received = std::make_shared<std::string>();
+            req.onData([received](std::string_view data) { received->append(data); });
+            req.onEnd([received, &res]() { res.send("got " + *received); });
+        };
+        {
+            Loopback loop(route, 1, {}, stack);
+            loop.send("POST /up HTTP/1.1\r\nHost: a\r\nAuthorization: yes\r\nContent-Length: 5\r\n\r\nhello");
+            const std::string response = loop.readResponse();
+            assert(response.find("X-Server: 1\r\n") != std::string::npos);
+            assert(response.find("X-Route: 1\r\n") != std::string::npos);
+            assert(response.compare(response.size() - 9, std::string::npos, "got hello") == 0);
+        }
+        {
+            Loopback loop(route, 1, {}, stack);
+            loop.send("POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\nExpect: 100-continue\r\n\r\n");
+            const std::string response = loop.readResponse();
+            assert(response.rfind("HTTP/1.1 401", 0) == 0); // No 100 Continue first
+            assert(response.find("X-Route") == std::string::npos);
+            assert(loop.closedByServer());
+        }
+    }
+
+    // Streamed responses: one chunk per write(), close-delimited for
+    // HTTP/1.0, and a producer that waits for onDrain() once write() pushes back
+    {
+        std::atomic<bool> paused{false};
+        std::atomic<bool> drained{false};
+        const std::string big(4 << 20, 'x'); // Far more than the socket buffers hold
+        Route route;
+        route.handler = [&](Request& req, Response& res) {
+            if (req.path != "/big") {
+                res.write("hello");
+                res.write("world!");
+                res.end();
+                return;
+            }
+            while (res.write(big)) {
+            }
+            paused = true;
+            res.onDrain([&drained, &res]() {
+                drained = true;
+                res.write("tail");
+                res.end();
+            });
+        };
+        {
+            Loopback loop(route);
+            loop.send("GET /s HTTP/1.1\r\nHost: a\r\n\r\n");
+            const std::string head = loop.readUntil("\r\n\r\n");
+            assert(head.find("Transfer-Encoding: chunked\r\n") != std::string::npos);
+            assert(head.find("Content-Length") == std::string::npos);
+            assert(loop.readUntil("0\r\n\r\n") == "5\r\nhello\r\n6\r\nworld!\r\n0\r\n\r\n");
+        }
+        {
+            Loopback loop(route);
+            loop.send("GET /s HTTP/1.0\r\n\r\n");
+            const std::string response = loop.readToEnd();
+            const std::size_t bodyAt = response.find("\r\n\r\n");
+            assert(response.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+            assert(response.find("Transfer-Encoding") == std::string::npos);
+            assert(response.substr(bodyAt + 4) == "helloworld!");
+        }
+        {
+            Loopback loop(route);
+            const int receiveBuffer = 64 << 10; // No autotuning up to megabytes
+            setsockopt(loop.client().native_handle(), SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+            loop.send("GET /big HTTP/1.1\r\nHost: a\r\n\r\n");
+            loop.readUntil("\r\n\r\n");
+            for (int i = 0; i < 500 && !paused; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            assert(paused);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            assert(!drained); // Nothing drains while the client reads nothing
+            const std::string body = loop.readUntil("0\r\n\r\n");
+            assert(drained);
+            assert(body.size() > 2 * big.size());
+            assert(body.compare(body.size() - 14, std::string::npos, "4\r\ntail\r\n0\r\n\r\n") == 0);
+        }
+    }
+
+    // Streamed request bodies: onData() sees each segment as it arrives and
+    // onEnd() runs once; an oversized Expect: 100-continue request gets 413
+    // instead of 100 Continue
+    {
+        std::vector<std::string> segments;
+        int ends = 0;
+        Route route;
+        route.options.streamBody = true;
+        route.options.maxBodyBytes = 64;
+        route.handler = [&](Request& req, Response& res) {
+            req.onData([&segments](std::string_view data) { segments.emplace_back(data); });
+            req.onEnd([&ends, &res]() {
+                ++ends;
+                res.send("ok");
+            });
+        };
+        {
+            Loopback loop(route);
+            loop.client().set_option(boost::asio::ip::tcp::no_delay(true));
+            loop.send("POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: 10\r\n\r\n");
+            for (const char* segment : {"hel", "lo", "world"}) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                loop.send(segment);
+            }
+            assert(loop.readResponse().find("\r\n\r\nok") != std::string::npos);
+            assert((segments == std::vector<std::string>{"hel", "lo", "world"}));
+            assert(ends == 1);
+        }
+        {
+            Loopback loop(route);
+            loop.send("POST /up HTTP/1.1\r\nHost: a\r\nContent-Length: 65\r\nExpect: 100-continue\r\n\r\n");
+            assert(loop.readResponse().rfind("HTTP/1.1 413", 0) == 0);
+            assert(ends == 1);
+        }
+    }
+
+    // Transfer-Encoding: only a lone, final chunked is decoded; a length
+    // next to it is refused, and codings the server cannot undo get 501
+    {
+        assert(Connection::transferEncodingStatus("chunked") == 0);
+        assert(Connection::transferEncodingStatus(" Chunked ,") == 0);
+        assert(Connection::transferEncodingStatus("gzip, chunked") == 501);
+        assert(Connection::transferEncodingStatus("chunked, gzip") == 400);
+        assert(Connection::transferEncodingStatus("chunked, chunked") == 400);
+        assert(Connection::transferEncodingStatus("identity") == 400);
+        assert(Connection::transferEncodingStatus("") == 400);
+
+        Route route;
+        route.handler = [](Request& req, Response& res) { res.send(req.body); };
+        const std::pair<const char*, const char*> requests[] = {
+            {"Content-Length: 5\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n", "HTTP/1.1 400"},
+            {"Transfer-Encoding: chunked, identity\r\n\r\nhello", "HTTP/1.1 400"},
+            {"Transfer-Encoding: gzip, chunked\r\n\r\n0\r\n\r\n", "HTTP/1.1 501"},
+            {"Transfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n", "HTTP/1.1 200"},
+        };
+        for (const auto& [headers, status] : requests) {
+            Loopback loop(route);
+            loop.send(std::string("POST / HTTP/1.1\r\nHost: a\r\n") + headers);
+            const std::string response = loop.readResponse();
+            assert(response.rfind(status, 0) == 0);
+            if (response.rfind("HTTP/1.1 200", 0) == 0) {
+                assert(response.compare(response.size() - 5, std::string::npos, "hello") == 0);
+            } else {
+                assert(response.find("Connection: close\r\n") != std::string::npos && loop.closedByServer());
+            }
+        }
+    }
+
+    // Pipelining: three requests in one segment are answered in order, and
+    // the connection closes after the one that asked for it
+    {
+        Route route;
+        route.handler = [](Request& req, Response& res) {
+            res.send(req.path + " " + req.body);
+        };
+        Loopback loop(route);
+        loop.send("GET /1 HTTP/1.1\r\nHost: a\r\n\r\n"
+                  "POST /2 HTTP/1.1\r\nHost: a\r\nContent-Length: 3\r\n\r\nabc"
+                  "GET /3 HTTP/1.1\r\nHost: a\r\nConnection: close\r\n\r\n");
+        const std::string first = loop.readResponse();
+        const std::string second = loop.readResponse();
+        const std::string third = loop.readResponse();
+        assert(first.find("Connection: keep-alive\r\n") != std::string::npos);
+        assert(first.compare(first.size() - 3, std::string::npos, "/1 ") == 0);
+        assert(second.find("Connection: keep-alive\r\n") != std::string::npos);
+        assert(second.compare(second.size() - 6, std::string::npos, "/2 abc") == 0);
+        assert(third.find("Connection: close\r\n") != std::string::npos);
+        assert(third.compare(third.size() - 3, std::string::npos, "/3 ") == 0);
+        assert(loop.closedByServer());
+    }
+
+    // A middleware may keep next and resume the chain after run() returns
+    {
+        MiddlewareStack stack;
+        std::function<void(std::exception_ptr)> saved;
+        stack.use([&](Request&, Response&, Context& ctx, std::function<void(std::exception_ptr)> next) {
+            ctx.set("user", std::string("ada"));
+            saved = std::move(next);
+        });
+        stack.use([](Request&, Response& res, Context& ctx, std::function<void(std::exception_ptr)> next) {
+            res.body = ctx.get<std::string>("user");
+            next(nullptr);
+        });
+        Request req;
+        Response res;
+        bool reached = false;
+        stack.run(req, res, [&] { reached = true; });
+        assert(!reached && saved);
+        saved(nullptr);
+        assert(reached && res.body == "ada");
+    }
+
+    // Deferred responses complete once, from any thread
+    {
+        Response res;
+        DeferredResponse done = res.defer();
+        assert(done.pending());
+        std::thread([done]() mutable {
+            done.complete([](Response& r) { r.send("later", 202); });
+            done.complete([](Response& r) { r.send("twice"); });
+        }).join();
+        assert(!done.pending() && res.body == "later" && res.statusCode == 202);
+
+        bool finished = false;
+        std::exception_ptr dropped;
+        DeferredResponse([&](DeferredResponse::Fill, std::exception_ptr error) {
+            finished = true;
+            dropped = error;
+        });
+        assert(finished && dropped);
+    }
+
+    // Deferred responses completed from foreign threads while four threads
+    // run the io_context: every response arrives whole and in order
+    {
+        std::mutex completersMutex;
+        std::vector<std::thread> completers;
+        Route route;
+        route.handler = [&](Request& req, Response& res) {
+            res.setHeader("X-Path", req.path);
+            DeferredResponse done = res.defer();
+            std::lock_guard<std::mutex> lock(completersMutex);
+            completers.emplace_back([done, path = req.path]() mutable {
+                if (path == "/drop") {
+                    return; // The last copy goes away without completing
+                }
+                done.complete([path](Response& r) { r.send("done " + path); });
+            });
+        };
+        {
+            Loopback loop(route, 4);
+            for (int i = 0; i < 50; ++i) {
+                const std::string path = "/item/" + std::to_string(i);
+                loop.send("GET " + path + " HTTP/1.1\r\nHost: a\r\n\r\n");
+                const std::string response = loop.readResponse();
+                assert(response.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+                assert(response.find("X-Path: " + path + "\r\n") != std::string::npos);
+                assert(response.size() > path.size() + 5 &&
+                       response.compare(response.size() - path.size() - 5, std::string::npos, "done " + path) == 0);
+            }
+
+            // Pipelined: the second waits for the first's completion
+            loop.send("GET /p/1 HTTP/1.1\r\nHost: a\r\n\r\nGET /p/2 HTTP/1.1\r\nHost: a\r\n\r\n");
+            assert(loop.readResponse().find("done /p/1") != std::string::npos);
+            assert(loop.readResponse().find("done /p/2") != std::string::npos);
+
+            loop.send("GET /drop HTTP/1.1\r\nHost: a\r\n\r\n");
+            assert(loop.readResponse().rfind("HTTP/1.1 500", 0) == 0);
+            std::lock_guard<std::mutex> lock(completersMutex);
+            for (auto& completer : completers) {
+                completer.join();
+            }
+        }
+    }
+
+    // Blocking executor: a full queue refuses work, and waits are measured
+    {
+        std::promise<void> gate;
+        std::shared_future<void> opened = gate.get_future().share();
+        {
+            Aether::BlockingExecutor::Options options;
+            options.threads = 1;
+            options.maxQueue = 1;
+            Aether::BlockingExecutor executor(options);
+            std::promise<void> started;
+            assert(executor.submit([&started, opened] {
+                started.set_value();
+                opened.wait();
+            }));
+            started.get_future().wait(); // The one thread is busy
+            assert(executor.submit([] {}));
+            assert(!executor.submit([] {}));
+            const auto stats = executor.stats();
+            assert(stats.queueDepth == 1 && stats.running == 1 && stats.rejected == 1);
+            gate.set_value();
+        } // Runs what is queued before joining
+        assert(RouteOptions().blocking().runBlocking);
+    }
+
+    // A blocking route runs its whole chain on the pool: middleware sees the
+    // handler's response after next(), and a deferred completion waits for
+    // the chain to return before it fills the response
+    {
+        Aether::BlockingExecutor pool;
+        MiddlewareStack stack;
+        stack.use([](Request&, Response& res, Context&, std::function<void(std::exception_ptr)> next) {
+            const std::thread::id before = std::this_thread::get_id();
+            next(nullptr);
+            assert(std::this_thread::get_id() == before && Aether::BlockingExecutor::onPoolThread());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Let a deferred completion arrive
+            res.setHeader("X-Seen", res.body.empty() ? "none" : res.body);
+        });
+        Route route;
+        route.blocking = &pool;
+        route.handler = [](Request& req, Response& res) {
+            if (req.path == "/deferred") {
+                DeferredResponse done = res.defer();
+                std::thread([done]() mutable {
+                    done.complete([](Response& r) { r.send("late"); });
+                }).join();
+                return;
+            }
+            res.send("rendered");
+        };
+        Loopback loop(route, 2, {}, std::move(stack));
+        loop.send("GET /now HTTP/1.1\r\nHost: a\r\n\r\n");
+        std::string response = loop.readResponse();
+        assert(response.find("X-Seen: rendered\r\n") != std::string::npos);
+        assert(response.compare(response.size() - 8, std::string::npos, "rendered") == 0);
+        loop.send("GET /deferred HTTP/1.1\r\nHost: a\r\n\r\n");
+        response = loop.readResponse();
+        assert(response.find("X-Seen: none\r\n") != std::string::npos);
+        assert(response.compare(response.size() - 4, std::string::npos, "late") == 0);
+    }
+
+#if defined(AETHER_IO_URING)
+    assert(std::string(Aether::EventLoop::ioBackend()) == "io_uring");
+#elif defined(__linux__)
+    assert(std::string(Aether::EventLoop::ioBackend()) == "epoll");
+#endif
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+    // Coroutine handlers and middleware run to completion outside a connection
+    {
+        MiddlewareStack stack;
+        std::vector<std::string> order;
+        stack.use(coroutine([&](Request&, Response&, Context&, Next next) -> boost::asio::awaitable<void> {
+            order.push_back("before");
+            co_await next();
+            order.push_back("after");
+        }));
+        auto handler = coroutine([&](Request&, Response& res) -> boost::asio::awaitable<void> {
+            boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor,
+                                            std::chrono::milliseconds(1));
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            order.push_back("handler");
+            res.send("done");
+        });
+        Request req;
+        Response res;
+        stack.run(req, res, [&] { handler(req, res); });
+        assert((order == std::vector<std::string>{"before", "handler", "after"}));
+        assert(res.body == "done");
+
+        bool threw = false;
+        try {
+            coroutine([](Request&, Response&) -> boost::asio::awaitable<void> {
+                throw std::runtime_error("boom");
+                co_return;
+            })(req, res);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // Over a connection, middleware and a handler suspended on a timer resume
+    // on the connection's strand, and the response waits for both
+    {
+        MiddlewareStack stack;
+        stack.use(coroutine([](Request&, Response& res, Context&, Next next) -> boost::asio::awaitable<void> {
+            co_await next();
+            res.setHeader("X-After", res.body);
+        }));
+        Route route;
+        route.handler = coroutine([](Request& req, Response& res) -> boost::asio::awaitable<void> {
+            boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor,
+                                            std::chrono::milliseconds(20));
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            res.send("slept " + req.path);
+        });
+        Loopback loop(route, 4, {}, std::move(stack));
+        for (const char* path : {"/a", "/b"}) {
+            loop.send(std::string("GET ") + path + " HTTP/1.1\r\nHost: a\r\n\r\n");
+            const std::string response = loop.readResponse();
+            assert(response.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+            assert(response.find(std::string("X-After: slept ") + path + "\r\n") != std::string::npos);
+            assert(response.compare(response.size() - 8, std::string::npos, std::string("slept ") + path) == 0);
+        }
+    }
+
+    // On a blocking route the same coroutines finish on the pool thread
+    {
+        Aether::BlockingExecutor pool;
+        MiddlewareStack stack;
+        stack.use(coroutine([](Request&, Response& res, Context&, Next next) -> boost::asio::awaitable<void> {
+            co_await next();
+            res.setHeader("X-After", res.body);
+        }));
+        Route route;
+        route.blocking = &pool;
+        route.handler = coroutine([](Request&, Response& res) -> boost::asio::awaitable<void> {
+            boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor,
+                                            std::chrono::milliseconds(5));
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            assert(Aether::BlockingExecutor::onPoolThread());
+            res.send("pooled");
+        });
+        Loopback loop(route, 2, {}, std::move(stack));
+        loop.send("GET / HTTP/1.1\r\nHost: a\r\n\r\n");
+        const std::string response = loop.readResponse();
+        assert(response.find("X-After: pooled\r\n") != std::string::npos);
+    }
+#endif
+
+    // Timer wheel: entries fire on their exact tick at every level, and can be
+    // moved or cancelled
+    {
+        TimerWheel wheel;
+        const std::uint64_t expiries[] = {1, 63, 64, 65, 4095, 4096, 4097, 300000, 20000000};
+        TimerWheel::Entry entries[9];
+        for (std::size_t i = 0; i < 9; ++i) {
+            wheel.schedule(entries[i], expiries[i]);
+        }
+        TimerWheel::Entry moved, cancelled;
+        wheel.schedule(moved, 10);
+        wheel.schedule(moved, 5000);
+        wheel.schedule(cancelled, 100);
+        wheel.cancel(cancelled);
+        assert(wheel.size() == 10 && !cancelled.scheduled());
+
+        std::vector<std::uint64_t> fired;
+        for (std::uint64_t tick = 1; tick <= 20000000; tick += 37) {
+            wheel.advance(tick, [&](TimerWheel::Entry& entry) {
+                assert(entry.expiry() <= wheel.now() && entry.expiry() + 37 > wheel.now());
+                fired.push_back(wheel.now());
+            });
+        }
+        wheel.advance(20000000, [&](TimerWheel::Entry&) { fired.push_back(wheel.now()); });
+        assert(fired == (std::vector<std::uint64_t>{1, 63, 64, 65, 4095, 4096, 4097, 5000, 300000, 20000000}));
+        assert(wheel.size() == 0 && !moved.scheduled());
+
+        // Scheduling in the past fires on the next tick
+        TimerWheel::Entry late;
+        wheel.schedule(late, 3);
+        std::size_t count = 0;
+        wheel.advance(wheel.now() + 1, [&](TimerWheel::Entry&) { ++count; });
+        assert(count == 1);
+    }
+
+    // Well-known names written straight into res.headers go out once, and
+    // the slot wins over them; they can close the connection too
+    {
+        Route route;
+        route.handler = [](Request&, Response& res) {
+            res.setHeader("Content-Type", "text/csv");
+            res.headers["content-type"] = "text/plain";
+            res.headers["Cache-Control"] = "no-store";
+            res.headers["Connection"] = "close";
+            res.headers["X-Custom"] = "1";
+            assert(res.getHeader("content-TYPE") == "text/csv" && res.getHeader("x-custom") == "1");
+            res.send("ok");
+        };
+        Loopback loop(route);
+        loop.send("GET / HTTP/1.1\r\nHost: a\r\n\r\n");
+        const std::string response = loop.readToEnd();
+        assert(response.find("Content-Type: text/csv\r\n") != std::string::npos);
+        assert(response.find("text/plain") == std::string::npos);
+        assert(response.find("Cache-Control: no-store\r\n") != std::string::npos);
+        assert(response.find("Connection: close\r\n") != std::string::npos);
+        assert(response.find("X-Custom: 1\r\n") != std::string::npos);
+        assert(response.find("onnection: close", response.find("onnection: close") + 1) == std::string::npos);
+    }
+
+    // Timeouts close a stalled connection on the wheel (one thread) and on the
+    // connection's own timer (several), and a served request re-arms them
+    for (const std::size_t threads : {1, 2}) {
+        Route route;
+        route.handler = [](Request&, Response& res) { res.send("ok"); };
+        ConnectionOptions options;
+        options.timeouts.idle = std::chrono::milliseconds(300);
+        options.timeouts.header = std::chrono::milliseconds(300);
+        Loopback loop(route, threads, options);
+        loop.send("GET / HTTP/1.1\r\nHost: a\r\n\r\n");
+        assert(loop.readResponse().find("\r\n\r\nok") != std::string::npos);
+        loop.send("GET / HTTP/1.1\r\n"); // Then nothing more
+        const auto start = std::chrono::steady_clock::now();
+        loop.readToEnd();
+        const auto waited = std::chrono::steady_clock::now() - start;
+        assert(waited >= std::chrono::milliseconds(250) && waited < std::chrono::seconds(4));
     }
 
     std::filesystem::remove_all(tempDir);